@@ -0,0 +1,102 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace eng::bench {
+
+	/*
+	 * Measures elapsed time, and cache references/misses through perf_event_open where it is available.
+	 * On other platforms (or if the kernel doesn't allow user space perf events) only the elapsed time is measured.
+	 */
+	class PerfCounters {
+	public:
+		struct Result {
+			double seconds = 0.0;
+			std::optional<uint64_t> cacheReferences;
+			std::optional<uint64_t> cacheMisses;
+			std::optional<uint64_t> l1dReadMisses;
+		};
+
+	private:
+		int fdReferences = -1;
+		int fdMisses = -1;
+		int fdL1d = -1;
+		std::chrono::steady_clock::time_point startTime;
+
+	public:
+		PerfCounters() {
+#if defined(__linux__)
+			fdReferences = open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_REFERENCES);
+			fdMisses = open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+			fdL1d = open(PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16));
+#endif
+		}
+		PerfCounters(const PerfCounters&) = delete;
+		PerfCounters& operator =(const PerfCounters&) = delete;
+		~PerfCounters() {
+#if defined(__linux__)
+			for (const int fd : { fdReferences, fdMisses, fdL1d })
+				if (fd >= 0) close(fd);
+#endif
+		}
+
+		inline bool hasHardwareCounters() const noexcept { return fdMisses >= 0; }
+
+		void start() {
+#if defined(__linux__)
+			for (const int fd : { fdReferences, fdMisses, fdL1d }) {
+				if (fd >= 0) {
+					ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+					ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+				}
+			}
+#endif
+			startTime = std::chrono::steady_clock::now();
+		}
+
+		Result stop() {
+			Result result;
+			result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+#if defined(__linux__)
+			result.cacheReferences = read(fdReferences);
+			result.cacheMisses = read(fdMisses);
+			result.l1dReadMisses = read(fdL1d);
+#endif
+			return result;
+		}
+
+	private:
+#if defined(__linux__)
+		static int open(const uint32_t type, const uint64_t config) {
+			perf_event_attr attr;
+			std::memset(&attr, 0, sizeof(attr));
+			attr.size = sizeof(attr);
+			attr.type = type;
+			attr.config = config;
+			attr.disabled = 1;
+			attr.exclude_kernel = 1;
+			attr.exclude_hv = 1;
+			return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+		}
+
+		static std::optional<uint64_t> read(const int fd) {
+			if (fd < 0) return std::nullopt;
+			ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+			uint64_t count = 0;
+			if (::read(fd, &count, sizeof(count)) != sizeof(count)) return std::nullopt;
+			return count;
+		}
+#endif
+	};
+
+}
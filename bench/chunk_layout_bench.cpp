@@ -0,0 +1,143 @@
+// compares the ChunkDataOrder layouts on two access patterns that the game uses:
+//  - meshing: visit every cell in storage order, and test the 6 neighbors of every solid cell for visible faces
+//  - stencil: visit every cell in xyz loop order (like fluid and light propagation), and sum the 6 neighbors
+// usage: chunk_layout_bench [chunks] [iterations]
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <glm/vec3.hpp>
+
+#include "world/chunk/ChunkData.h"
+#include "PerfCounters.h"
+
+using namespace eng;
+using bench::PerfCounters;
+
+namespace {
+
+	constexpr size_t chunk_width = 32;
+	using State = uint32_t;
+
+	template<ChunkDataOrder Order>
+	using BenchData = ChunkData<State, chunk_width, Order>;
+
+	constexpr glm::ivec3 neighbor_offsets[6] {
+		{ -1, 0, 0 }, { 1, 0, 0 }, { 0, -1, 0 }, { 0, 1, 0 }, { 0, 0, -1 }, { 0, 0, 1 },
+	};
+
+	inline bool inBounds(const glm::ivec3& p) noexcept {
+		return (p.x >= 0) && (p.y >= 0) && (p.z >= 0) &&
+			(p.x < static_cast<int>(chunk_width)) && (p.y < static_cast<int>(chunk_width)) && (p.z < static_cast<int>(chunk_width));
+	}
+
+	// rolling terrain with some caves, so that both the solid and the empty parts of a chunk have surfaces
+	template<ChunkDataOrder Order>
+	std::vector<std::unique_ptr<BenchData<Order>>> makeChunks(const size_t count) {
+		std::vector<std::unique_ptr<BenchData<Order>>> chunks;
+		chunks.reserve(count);
+		for (size_t c = 0; c < count; c++) {
+			auto& data = *chunks.emplace_back(std::make_unique<BenchData<Order>>());
+			BenchData<Order>::forEachPos([&](const size_t i, const glm::ivec3& p) {
+				const float fx = static_cast<float>(p.x + static_cast<int>(c * 7));
+				const float fz = static_cast<float>(p.z + static_cast<int>(c * 13));
+				const float height = 16.0f + 6.0f * std::sin(fx * 0.21f) * std::cos(fz * 0.17f);
+				const bool cave = std::sin(fx * 0.5f + p.y * 0.3f) * std::cos(fz * 0.4f - p.y * 0.2f) > 0.6f;
+				data[i] = (static_cast<float>(p.y) < height && !cave) ? 1 + ((p.x ^ p.y ^ p.z) & 3) : 0;
+			});
+		}
+		return chunks;
+	}
+
+	template<ChunkDataOrder Order>
+	uint64_t meshingPass(const std::vector<std::unique_ptr<BenchData<Order>>>& chunks) {
+		uint64_t faces = 0;
+		for (const auto& chunk : chunks) {
+			const auto& data = *chunk;
+			BenchData<Order>::forEachPos([&](const size_t i, const glm::ivec3& p) {
+				if (data[i] == 0) return;
+				for (const auto& offset : neighbor_offsets) {
+					const glm::ivec3 n { p.x + offset.x, p.y + offset.y, p.z + offset.z };
+					if (!inBounds(n) || (data[n] == 0)) faces++;
+				}
+			});
+		}
+		return faces;
+	}
+
+	template<ChunkDataOrder Order>
+	uint64_t stencilPass(const std::vector<std::unique_ptr<BenchData<Order>>>& chunks, BenchData<Order>& out) {
+		uint64_t checksum = 0;
+		for (const auto& chunk : chunks) {
+			const auto& data = *chunk;
+			for (int z = 0; z < static_cast<int>(chunk_width); z++) {
+				for (int y = 0; y < static_cast<int>(chunk_width); y++) {
+					for (int x = 0; x < static_cast<int>(chunk_width); x++) {
+						const glm::ivec3 p { x, y, z };
+						State sum = data[p];
+						for (const auto& offset : neighbor_offsets) {
+							const glm::ivec3 n { x + offset.x, y + offset.y, z + offset.z };
+							if (inBounds(n)) sum += data[n];
+						}
+						out[p] = sum;
+					}
+				}
+			}
+			checksum += out[BenchData<Order>::volume / 2];
+		}
+		return checksum;
+	}
+
+	std::string formatCount(const std::optional<uint64_t>& count) {
+		return count ? std::to_string(*count) : std::string("n/a");
+	}
+
+	void printResult(const char* orderName, const char* passName, const PerfCounters::Result& result, const uint64_t checksum) {
+		std::printf("%-8s %-8s %10.3f ms %16s %16s %16s   (%llu)\n", orderName, passName, result.seconds * 1000.0,
+			formatCount(result.cacheReferences).c_str(), formatCount(result.cacheMisses).c_str(), formatCount(result.l1dReadMisses).c_str(),
+			static_cast<unsigned long long>(checksum));
+	}
+
+	template<ChunkDataOrder Order>
+	void runOrder(const char* orderName, const size_t chunkCount, const size_t iterations, PerfCounters& counters) {
+		const auto chunks = makeChunks<Order>(chunkCount);
+		auto out = std::make_unique<BenchData<Order>>();
+
+		meshingPass<Order>(chunks); // warm up
+		counters.start();
+		uint64_t faces = 0;
+		for (size_t i = 0; i < iterations; i++) faces += meshingPass<Order>(chunks);
+		printResult(orderName, "meshing", counters.stop(), faces);
+
+		stencilPass<Order>(chunks, *out); // warm up
+		counters.start();
+		uint64_t checksum = 0;
+		for (size_t i = 0; i < iterations; i++) checksum += stencilPass<Order>(chunks, *out);
+		printResult(orderName, "stencil", counters.stop(), checksum);
+	}
+
+}
+
+int main(int argc, char** argv) {
+	// the default working set (256 chunks of 128 KiB) is larger than the last level cache of most cpus
+	const size_t chunkCount = (argc > 1) ? std::strtoull(argv[1], nullptr, 10) : 256;
+	const size_t iterations = (argc > 2) ? std::strtoull(argv[2], nullptr, 10) : 8;
+
+	PerfCounters counters;
+	if (!counters.hasHardwareCounters())
+		std::printf("hardware counters unavailable (check /proc/sys/kernel/perf_event_paranoid), only reporting time\n");
+	std::printf("%zu chunks, %zu iterations\n", chunkCount, iterations);
+	std::printf("%-8s %-8s %13s %16s %16s %16s\n", "order", "pass", "time", "cache refs", "cache misses", "L1d misses");
+
+	runOrder<ChunkDataOrder::ZYX>("ZYX", chunkCount, iterations, counters);
+	runOrder<ChunkDataOrder::YZX>("YZX", chunkCount, iterations, counters);
+	runOrder<ChunkDataOrder::Morton>("Morton", chunkCount, iterations, counters);
+	runOrder<ChunkDataOrder::Brick4>("Brick4", chunkCount, iterations, counters);
+
+	return 0;
+}
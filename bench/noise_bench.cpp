@@ -0,0 +1,124 @@
+// measures the per sample cost of NoiseGen with each gradient mode:
+//  - hashed:      the gradient of each lattice point is picked by hashing it with the seed and seeding an RNG
+//  - permutation: the gradient is looked up in the permutation table that the generator shuffled from its seed
+// each mode is timed with getNoise (one sample at a time) and fillNoise (a box at a time), in 2d and 3d,
+// and the fills are checked against getNoise
+// usage: noise_bench [boxes] [iterations]
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+
+#include "util/math/NoiseGen.h"
+#include "PerfCounters.h"
+
+using namespace eng;
+using bench::PerfCounters;
+
+namespace {
+
+	constexpr int width = 32;
+	constexpr RNG::seed_t seed = 1;
+	constexpr NoiseGen::NoiseParams params { 64.0, 1.0, 0.5, 4 };
+
+	const char* getModeName(const NoiseGen::GradientMode mode) {
+		return (mode == NoiseGen::GradientMode::Hashed) ? "hashed" : "permutation";
+	}
+
+	// the largest difference between fillNoise and getNoise in a box of each dimension
+	double getFillError(const NoiseGen& noise) {
+		double error = 0.0;
+		std::vector<double> samples(width * width * width);
+		const glm::ivec2 origin2d { -100, 37 };
+		noise.fillNoise2D(origin2d, { width, width }, samples);
+		for (int y = 0; y < width; y++)
+			for (int x = 0; x < width; x++)
+				error = std::max(error, std::abs(samples[static_cast<size_t>((y * width) + x)] - noise.getNoise(origin2d + glm::ivec2(x, y))));
+		const glm::ivec3 origin3d { 71, -20, -45 };
+		noise.fillNoise3D(origin3d, { width, width, width }, samples);
+		for (int z = 0; z < width; z++)
+			for (int y = 0; y < width; y++)
+				for (int x = 0; x < width; x++)
+					error = std::max(error, std::abs(samples[static_cast<size_t>((((z * width) + y) * width) + x)] - noise.getNoise(origin3d + glm::ivec3(x, y, z))));
+		return error;
+	}
+
+	template<typename F>
+	double run(const char* name, const NoiseGen::GradientMode mode, const size_t samples, PerfCounters& counters, F&& sample) {
+		counters.start();
+		const double sum = sample();
+		const PerfCounters::Result result = counters.stop();
+		const double nanosPerSample = (result.seconds * 1e9) / static_cast<double>(samples);
+		std::printf("%-12s %-12s %10zu %10.2f ns   (sum %.3f)\n", getModeName(mode), name, samples, nanosPerSample, sum);
+		return nanosPerSample;
+	}
+
+	void runMode(const NoiseGen::GradientMode mode, const int boxes, const int iterations, PerfCounters& counters) {
+		const NoiseGen noise(seed, params, mode);
+		const size_t samples2d = static_cast<size_t>(boxes * iterations) * (width * width);
+		const size_t samples3d = static_cast<size_t>(boxes) * (width * width * width);
+
+		run("scalar2d", mode, samples2d, counters, [&]() {
+			double sum = 0.0;
+			for (int i = 0; i < iterations; i++)
+				for (int b = 0; b < boxes; b++)
+					for (int y = 0; y < width; y++)
+						for (int x = 0; x < width; x++)
+							sum += noise.getNoise(glm::ivec2((b * width) + x, y));
+			return sum;
+		});
+		run("fill2d", mode, samples2d, counters, [&]() {
+			double sum = 0.0;
+			std::vector<double> out(width * width);
+			for (int i = 0; i < iterations; i++) {
+				for (int b = 0; b < boxes; b++) {
+					noise.fillNoise2D({ b * width, 0 }, { width, width }, out);
+					sum += out[0];
+				}
+			}
+			return sum;
+		});
+		run("scalar3d", mode, samples3d, counters, [&]() {
+			double sum = 0.0;
+			for (int b = 0; b < boxes; b++)
+				for (int z = 0; z < width; z++)
+					for (int y = 0; y < width; y++)
+						for (int x = 0; x < width; x++)
+							sum += noise.getNoise(glm::ivec3((b * width) + x, y, z));
+			return sum;
+		});
+		run("fill3d", mode, samples3d, counters, [&]() {
+			double sum = 0.0;
+			std::vector<double> out(width * width * width);
+			for (int b = 0; b < boxes; b++) {
+				noise.fillNoise3D({ b * width, 0, 0 }, { width, width, width }, out);
+				sum += out[0];
+			}
+			return sum;
+		});
+		std::printf("%-12s max difference between fillNoise and getNoise: %g\n", getModeName(mode), getFillError(noise));
+	}
+
+}
+
+int main(int argc, char** argv) {
+	const int boxes = (argc > 1) ? std::atoi(argv[1]) : 16;
+	const int iterations = (argc > 2) ? std::atoi(argv[2]) : 32; // 2d boxes are repeated, so they take about as long as the 3d boxes
+
+	PerfCounters counters;
+	if (!counters.hasHardwareCounters())
+		std::printf("hardware counters unavailable (check /proc/sys/kernel/perf_event_paranoid), only reporting time\n");
+	std::printf("%d boxes of %d^2 (x%d) and %d^3 samples, %d octaves\n", boxes, width, iterations, width, params.octaves);
+	std::printf("%-12s %-12s %10s %13s\n", "gradients", "sampling", "samples", "time/sample");
+
+	runMode(NoiseGen::GradientMode::Hashed, boxes, iterations, counters);
+	runMode(NoiseGen::GradientMode::Permutation, boxes, iterations, counters);
+
+	return 0;
+}
@@ -0,0 +1,163 @@
+// compares the cost of generating the blocks of a chunk with three terrain shapes:
+//  - height2d:  2d heightmap, one noise sample per column (the terrain before 3d density)
+//  - block3d:   3d density with one noise sample per block (the old commented out isSolid path in Chunk::generate)
+//  - lattice3d: 3d density sampled on TerrainDensity's coarse lattice and interpolated, with a single top-down pass per column
+// the chunks are a grid of columns around the terrain surface, and each chunk computes its own heights (no column cache)
+// usage: terrain_gen_bench [columns per side] [iterations]
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+
+#include "util/math/NoiseGen.h"
+#include "world/chunk/TerrainDensity.h"
+#include "PerfCounters.h"
+
+using namespace eng;
+using bench::PerfCounters;
+
+namespace {
+
+	constexpr int width = static_cast<int>(chunk_width);
+	constexpr int vertical_chunks = 4; // chunks per column, from 2 chunks below the average terrain height to 2 above
+	constexpr uint8_t air = 0, stone = 1, dirt = 2, grass = 3;
+
+	using Blocks = std::array<uint8_t, chunk_volume>;
+
+	struct Noise {
+		NoiseGen height { 1, { 123.0, 1.0, 0.6, 4 } };
+		NoiseGen density { 2, { 64.0, 1.0, 0.5, 3 } };
+	};
+
+	inline size_t posToIndex(const int x, const int y, const int z) noexcept {
+		return static_cast<size_t>((((z * width) + y) * width) + x);
+	}
+
+	inline uint8_t surfaceLayer(const int solidAbove) noexcept {
+		return (solidAbove > 2) ? stone : (solidAbove > 0) ? dirt : grass;
+	}
+
+	void getHeights(const Noise& noise, const glm::ivec3& origin, std::array<int, chunk_layer_size>& heights) {
+		std::array<double, chunk_layer_size> samples;
+		noise.height.fillNoise2D({ origin.x, origin.z }, { width, width }, samples);
+		for (size_t i = 0; i < samples.size(); i++) heights[i] = static_cast<int>(samples[i] * 512) - 128;
+	}
+
+	void generateHeight2D(const Noise& noise, const glm::ivec3& origin, Blocks& blocks) {
+		std::array<int, chunk_layer_size> heights;
+		getHeights(noise, origin, heights);
+		for (int z = 0; z < width; z++) {
+			for (int x = 0; x < width; x++) {
+				const int height = heights[static_cast<size_t>((z * width) + x)];
+				for (int y = 0; y < width; y++) {
+					const int depth = height - (origin.y + y);
+					blocks[posToIndex(x, y, z)] = (depth < 0) ? air : surfaceLayer(depth);
+				}
+			}
+		}
+	}
+
+	// the same density function as TerrainDensity, without the lattice
+	float getBlockDensity(const Noise& noise, const glm::ivec3& blockPos, const int terrainHeight) {
+		const float depth = static_cast<float>(terrainHeight - blockPos.y) + 0.5f;
+		const float surface = (depth > 0.0f) ? std::min(depth / TerrainDensity::depth_falloff, 1.0f) : (depth / TerrainDensity::height_falloff);
+		return surface + ((static_cast<float>(noise.density.getNoise(blockPos)) - 0.5f) * TerrainDensity::noise_strength);
+	}
+
+	void generateBlock3D(const Noise& noise, const glm::ivec3& origin, Blocks& blocks) {
+		std::array<int, chunk_layer_size> heights;
+		getHeights(noise, origin, heights);
+		for (int z = 0; z < width; z++) {
+			for (int x = 0; x < width; x++) {
+				const int height = heights[static_cast<size_t>((z * width) + x)];
+				int solidAbove = 0;
+				for (int y = width + TerrainDensity::column_above - 1; y >= 0; y--) {
+					const bool solid = TerrainDensity::isSolid(getBlockDensity(noise, origin + glm::ivec3(x, y, z), height));
+					if (y < width) blocks[posToIndex(x, y, z)] = (solid) ? surfaceLayer(solidAbove) : air;
+					solidAbove = (solid) ? (solidAbove + 1) : 0;
+				}
+			}
+		}
+	}
+
+	void generateLattice3D(const Noise& noise, const glm::ivec3& origin, Blocks& blocks) {
+		std::array<int, chunk_layer_size> heights;
+		getHeights(noise, origin, heights);
+		const TerrainDensity density(noise.density, origin, heights);
+		TerrainDensity::Column column;
+		for (int z = 0; z < width; z++) {
+			for (int x = 0; x < width; x++) {
+				density.getColumn(x, z, column);
+				int solidAbove = 0;
+				for (int c = static_cast<int>(TerrainDensity::column_height) - 1; c >= TerrainDensity::column_below; c--) {
+					const bool solid = TerrainDensity::isSolid(column[static_cast<size_t>(c)]);
+					const int y = c - TerrainDensity::column_below;
+					if (y < width) blocks[posToIndex(x, y, z)] = (solid) ? surfaceLayer(solidAbove) : air;
+					solidAbove = (solid) ? (solidAbove + 1) : 0;
+				}
+			}
+		}
+	}
+
+	// origins of the chunks in a square of columns, around the average terrain height
+	std::vector<glm::ivec3> getChunkOrigins(const int columnsPerSide) {
+		std::vector<glm::ivec3> origins;
+		for (int cz = 0; cz < columnsPerSide; cz++)
+			for (int cx = 0; cx < columnsPerSide; cx++)
+				for (int cy = 0; cy < vertical_chunks; cy++)
+					origins.emplace_back(cx * width, (cy + 2) * width, cz * width);
+		return origins;
+	}
+
+	std::string formatCount(const std::optional<uint64_t>& count) {
+		return count ? std::to_string(*count) : std::string("n/a");
+	}
+
+	template<typename F>
+	double run(const char* name, const std::vector<glm::ivec3>& origins, const size_t iterations, PerfCounters& counters, const Noise& noise, F&& generate) {
+		Blocks blocks {};
+		uint64_t solidBlocks = 0;
+		counters.start();
+		for (size_t i = 0; i < iterations; i++) {
+			for (const glm::ivec3& origin : origins) {
+				generate(noise, origin, blocks);
+				for (const uint8_t block : blocks) solidBlocks += (block != air);
+			}
+		}
+		const PerfCounters::Result result = counters.stop();
+		const double microsPerChunk = (result.seconds * 1e6) / static_cast<double>(origins.size() * iterations);
+		std::printf("%-10s %8zu %12.1f us %16s %16s   (%llu solid)\n", name, origins.size() * iterations, microsPerChunk,
+			formatCount(result.cacheReferences).c_str(), formatCount(result.cacheMisses).c_str(), static_cast<unsigned long long>(solidBlocks));
+		return microsPerChunk;
+	}
+
+}
+
+int main(int argc, char** argv) {
+	const int columnsPerSide = (argc > 1) ? std::atoi(argv[1]) : 8;
+	const size_t iterations = (argc > 2) ? std::strtoull(argv[2], nullptr, 10) : 4;
+
+	PerfCounters counters;
+	if (!counters.hasHardwareCounters())
+		std::printf("hardware counters unavailable (check /proc/sys/kernel/perf_event_paranoid), only reporting time\n");
+	const Noise noise;
+	const std::vector<glm::ivec3> origins = getChunkOrigins(columnsPerSide);
+	// per block noise is slow enough that a single column of chunks is plenty
+	const std::vector<glm::ivec3> blockOrigins(origins.begin(), origins.begin() + vertical_chunks);
+	std::printf("%zu chunks, %zu iterations\n", origins.size(), iterations);
+	std::printf("%-10s %8s %15s %16s %16s\n", "terrain", "chunks", "time/chunk", "cache refs", "cache misses");
+
+	const double height2d = run("height2d", origins, iterations, counters, noise, generateHeight2D);
+	const double block3d = run("block3d", blockOrigins, 1, counters, noise, generateBlock3D);
+	const double lattice3d = run("lattice3d", origins, iterations, counters, noise, generateLattice3D);
+	std::printf("lattice3d is %.1fx the cost of height2d, and %.0fx faster than block3d\n", lattice3d / height2d, block3d / lattice3d);
+
+	return 0;
+}
@@ -0,0 +1,252 @@
+// measures the throughput of world generation without a window or a world:
+// generates every chunk in a region with a ChunkGenerator, the same way the world does, and reports
+//  - the chunks generated per second
+//  - the number of times each generation stage ran and the time spent in it (summed over the generator threads)
+//  - the peak memory use of the process, and the most proto chunks kept at once
+//  - a hash of the generated blocks and fluids, which only changes if the generated contents change
+// generation is deterministic, so the hash has to be the same for every thread count
+// usage: worldgen_bench [seed] [size x] [size y] [size z] [threads] [permutation|hashed] [load]
+// the region is centered on chunk (0, 2, 0), which is around the average terrain height; threads = 0 uses the game's default
+// fails if no chunk completes for stall_timeout, and lists the chunks that never completed
+// with load, the generated chunks are also saved to region files in a temporary directory and loaded back with a single thread, through the
+// same ChunkStorage::loadChunk as the world (region file read, inflate, and deserialize), to compare loading a chunk with generating it.
+// the chunks are kept until they're saved, so the peak memory includes them
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(__linux__) || defined(__APPLE__)
+#include <sys/resource.h>
+#elif defined(_WIN32)
+#include <windows.h>
+#include <psapi.h>
+#endif
+
+#include "world/chunk/ChunkGenerator.h"
+#include "world/chunk/ChunkStorage.h"
+#include "world/chunk/TerrainGenerator.h"
+#include "util/math/RNG.h"
+
+using namespace eng;
+
+namespace {
+
+	constexpr uint64_t fnv_offset_basis = 14695981039346656037ull;
+	constexpr uint64_t fnv_prime = 1099511628211ull;
+
+	constexpr std::chrono::seconds stall_timeout { 30 };
+	constexpr size_t max_reported_missing = 32;
+
+	// the value is mixed first, since fnv only carries low bits upwards and the states differ in their high bits
+	inline uint64_t hashCombine(const uint64_t hash, uint64_t value) noexcept {
+		value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ull;
+		value = (value ^ (value >> 27)) * 0x94d049bb133111ebull;
+		return (hash ^ (value ^ (value >> 31))) * fnv_prime;
+	}
+
+	// hashes the state at every position, through the hash of each palette entry
+	template<typename Data, typename F>
+	uint64_t hashData(uint64_t hash, const Data& data, F&& hashState) {
+		const auto& palette = data.getPalette();
+		std::vector<uint64_t> paletteHashes(palette.size());
+		std::transform(palette.begin(), palette.end(), paletteHashes.begin(), hashState);
+		for (size_t i = 0; i < data.size(); i++)
+			hash = hashCombine(hash, paletteHashes[data.getPaletteIndex(i)]);
+		return hash;
+	}
+
+	uint64_t hashContents(const Chunk::Contents& contents) {
+		uint64_t hash = fnv_offset_basis;
+		hash = hashData(hash, *contents.blockData, [](const BlockState& state) {
+			return (static_cast<uint64_t>(state.getBlockId()) << 32) | static_cast<uint64_t>(state.getMetadata());
+		});
+		hash = hashData(hash, *contents.fluidData, [](const FluidState& state) {
+			return (static_cast<uint64_t>(state.getFluidId()) << 32) | static_cast<uint64_t>(state.getMetadata());
+		});
+		return hash;
+	}
+
+	// in KiB
+	std::optional<size_t> getPeakMemoryUsage() {
+#if defined(__linux__)
+		rusage usage {};
+		if (getrusage(RUSAGE_SELF, &usage) != 0) return std::nullopt;
+		return static_cast<size_t>(usage.ru_maxrss); // KiB on linux
+#elif defined(__APPLE__)
+		rusage usage {};
+		if (getrusage(RUSAGE_SELF, &usage) != 0) return std::nullopt;
+		return static_cast<size_t>(usage.ru_maxrss) / 1024; // bytes on macOS
+#elif defined(_WIN32)
+		PROCESS_MEMORY_COUNTERS counters {};
+		if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) return std::nullopt;
+		return static_cast<size_t>(counters.PeakWorkingSetSize) / 1024;
+#else
+		return std::nullopt;
+#endif
+	}
+
+	int readArg(const int argc, char** const argv, const int i, const int defaultValue) {
+		return (argc > i) ? std::atoi(argv[i]) : defaultValue;
+	}
+
+	// saves every chunk to region files in directory, then loads each of them back
+	// returns the seconds spent loading, or nullopt (after printing the reason) if a chunk couldn't be loaded or its contents changed
+	std::optional<double> measureLoading(const std::filesystem::path& directory, const std::vector<ChunkGenerator::Result>& chunks) {
+		{
+			ChunkStorage storage(directory);
+			for (const ChunkGenerator::Result& chunk : chunks) {
+				storage.saveChunk(chunk.chunkCoord, std::make_shared<Chunk::CompressedContents>(Chunk::CompressedContents {
+					CompressedChunkData<Chunk::BlockData>(*chunk.contents.blockData),
+					CompressedChunkData<Chunk::FluidData>(*chunk.contents.fluidData),
+				}));
+			}
+			storage.flush();
+		}
+
+		// a new storage, so that none of the chunks are served from the pending saves
+		ChunkStorage storage(directory);
+		const auto startTime = std::chrono::steady_clock::now();
+		std::vector<Chunk::Contents> loaded;
+		loaded.reserve(chunks.size());
+		for (const ChunkGenerator::Result& chunk : chunks) {
+			std::optional<Chunk::Contents> contents = storage.loadChunk(chunk.chunkCoord);
+			if (!contents) {
+				std::fprintf(stderr, "chunk (%d, %d, %d) couldn't be loaded\n", chunk.chunkCoord.x, chunk.chunkCoord.y, chunk.chunkCoord.z);
+				return std::nullopt;
+			}
+			loaded.push_back(std::move(*contents));
+		}
+		const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+		for (size_t i = 0; i < chunks.size(); i++) {
+			if (hashContents(loaded[i]) != hashContents(chunks[i].contents)) {
+				std::fprintf(stderr, "chunk (%d, %d, %d) changed when it was saved and loaded\n", chunks[i].chunkCoord.x, chunks[i].chunkCoord.y, chunks[i].chunkCoord.z);
+				return std::nullopt;
+			}
+		}
+		return seconds;
+	}
+
+}
+
+int main(int argc, char** argv) {
+	const RNG::seed_t seed = RNG::toSeed((argc > 1) ? argv[1] : "1"); // seeded from a string, like the game
+	const glm::ivec3 size {
+		std::max(readArg(argc, argv, 2, 8), 1),
+		std::max(readArg(argc, argv, 3, 8), 1),
+		std::max(readArg(argc, argv, 4, 8), 1),
+	};
+	const size_t threadCount = static_cast<size_t>(std::max(readArg(argc, argv, 5, 0), 0));
+	const auto gradientMode = ((argc > 6) && (std::strcmp(argv[6], "hashed") == 0)) ? NoiseGen::GradientMode::Hashed : NoiseGen::GradientMode::Permutation;
+	const bool measureLoad = (argc > 7) && (std::strcmp(argv[7], "load") == 0);
+	const glm::ivec3 regionMin = glm::ivec3(0, 2, 0) - (size / 2);
+	const size_t chunkCount = static_cast<size_t>(size.x) * static_cast<size_t>(size.y) * static_cast<size_t>(size.z);
+
+	// enough height cache for every column of the region and the neighbors generated around it
+	const TerrainGenerator terrain(seed, static_cast<size_t>(size.x + 2) * static_cast<size_t>(size.z + 2), gradientMode);
+	ChunkGenerator generator(terrain, threadCount);
+	std::printf("seed %llu, %d x %d x %d chunks from chunk (%d, %d, %d), %zu threads, %s gradients\n", static_cast<unsigned long long>(seed),
+		size.x, size.y, size.z, regionMin.x, regionMin.y, regionMin.z, generator.getThreadCount(),
+		(terrain.getGradientMode() == NoiseGen::GradientMode::Hashed) ? "hashed" : "permutation");
+
+	// the chunks are enqueued in column order, keeping the queue at the generator's capacity like the world does
+	std::vector<ChunkCoord> pending;
+	pending.reserve(chunkCount);
+	for (int x = 0; x < size.x; x++)
+		for (int z = 0; z < size.z; z++)
+			for (int y = size.y - 1; y >= 0; y--)
+				pending.emplace_back(regionMin + glm::ivec3(x, y, z));
+	// indexed by ((x * size.z) + z) * size.y + y, relative to regionMin
+	const auto getRegionIndex = [&](const ChunkCoord& chunkCoord) {
+		const glm::ivec3 p = static_cast<glm::ivec3>(chunkCoord) - regionMin;
+		return ((static_cast<size_t>(p.x) * static_cast<size_t>(size.z)) + static_cast<size_t>(p.z)) * static_cast<size_t>(size.y) + static_cast<size_t>(p.y);
+	};
+	std::vector<uint64_t> chunkHashes(chunkCount);
+	std::vector<bool> completed(chunkCount);
+	std::vector<ChunkGenerator::Result> generatedChunks; // only kept when loading is measured
+	size_t nextPending = 0;
+	size_t generated = 0;
+	size_t peakProtoChunks = 0;
+
+	const auto startTime = std::chrono::steady_clock::now();
+	auto lastProgressTime = startTime;
+	while (generated < chunkCount) {
+		for (size_t queued = generator.queuedTasks(); (nextPending < pending.size()) && (queued < generator.getQueueCapacity()); queued++)
+			generator.enqueue(pending[nextPending++]);
+		peakProtoChunks = std::max(peakProtoChunks, generator.getProtoChunkCount());
+
+		std::vector<ChunkGenerator::Result> results = generator.takeCompleted(chunkCount);
+		if (results.empty()) {
+			if ((std::chrono::steady_clock::now() - lastProgressTime) < stall_timeout) {
+				std::this_thread::sleep_for(std::chrono::microseconds(200));
+				continue;
+			}
+			std::fprintf(stderr, "no chunk completed for %llds, %zu of %zu chunks are missing:\n", static_cast<long long>(stall_timeout.count()),
+				chunkCount - generated, chunkCount);
+			size_t reported = 0;
+			for (size_t i = 0; (i < pending.size()) && (reported < max_reported_missing); i++) {
+				if (completed[getRegionIndex(pending[i])]) continue;
+				std::fprintf(stderr, "  (%d, %d, %d)%s\n", pending[i].x, pending[i].y, pending[i].z, (i < nextPending) ? "" : " (not enqueued yet)");
+				reported++;
+			}
+			return 1;
+		}
+		for (const ChunkGenerator::Result& result : results) {
+			const size_t i = getRegionIndex(result.chunkCoord);
+			chunkHashes[i] = hashContents(result.contents);
+			completed[i] = true;
+		}
+		generated += results.size();
+		if (measureLoad) std::move(results.begin(), results.end(), std::back_inserter(generatedChunks));
+		lastProgressTime = std::chrono::steady_clock::now();
+	}
+	const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+	uint64_t regionHash = fnv_offset_basis;
+	for (const uint64_t chunkHash : chunkHashes)
+		regionHash = hashCombine(regionHash, chunkHash);
+
+	std::printf("%zu chunks in %.3f s: %.1f chunks/s\n", chunkCount, seconds, static_cast<double>(chunkCount) / seconds);
+	const ChunkGenerator::StageStatsArray stageStats = generator.getStageStats();
+	double totalStageSeconds = 0.0;
+	for (const auto& stats : stageStats)
+		totalStageSeconds += std::chrono::duration<double>(stats.time).count();
+	std::printf("%-14s %8s %12s %12s %8s\n", "stage", "runs", "total ms", "us/run", "share");
+	for (const GenerationStage stage : generation_stage::stages) {
+		const auto& stats = stageStats[generation_stage::getIndex(stage)];
+		const double stageSeconds = std::chrono::duration<double>(stats.time).count();
+		std::printf("%-14s %8llu %12.2f %12.2f %7.1f%%\n", generation_stage::getName(stage), static_cast<unsigned long long>(stats.runs), stageSeconds * 1e3,
+			(stats.runs > 0) ? (stageSeconds * 1e6) / static_cast<double>(stats.runs) : 0.0, (totalStageSeconds > 0.0) ? (stageSeconds * 100.0) / totalStageSeconds : 0.0);
+	}
+	if (const auto peakMemory = getPeakMemoryUsage())
+		std::printf("peak memory: %.1f MiB, peak proto chunks: %zu\n", static_cast<double>(*peakMemory) / 1024.0, peakProtoChunks);
+	else
+		std::printf("peak memory: unavailable, peak proto chunks: %zu\n", peakProtoChunks);
+	std::printf("content hash: %016llx\n", static_cast<unsigned long long>(regionHash));
+
+	if (measureLoad) {
+		const std::filesystem::path directory = std::filesystem::temp_directory_path() / ("worldgen_bench_" + std::to_string(seed));
+		std::filesystem::remove_all(directory);
+		const std::optional<double> loadSeconds = measureLoading(directory, generatedChunks);
+		std::filesystem::remove_all(directory);
+		if (!loadSeconds) return 1;
+		// the stage times are summed over the generator threads, so both are the time a single thread spends on a chunk
+		// (generation includes the neighbors that were only generated as dependencies, which regenerating a chunk would also need)
+		const double loadUs = (*loadSeconds * 1e6) / static_cast<double>(chunkCount);
+		const double generationUs = (totalStageSeconds * 1e6) / static_cast<double>(chunkCount);
+		std::printf("loading: %.2f us/chunk, generation: %.2f us/chunk, loading is %.1fx faster\n", loadUs, generationUs, generationUs / loadUs);
+	}
+
+	return 0;
+}
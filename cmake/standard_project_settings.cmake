@@ -17,6 +17,19 @@ endif()
 # Generate compile_commands.json to make it easier to work with clang based tools
 set(CMAKE_EXPORT_COMPILE_COMMANDS ON)
 
+option(BUILD_BENCHMARKS "Build the benchmark executables in bench/" OFF)
+
+# Instruction set used by the SIMD code paths (see src/util/math/simd.h)
+set(SIMD_LEVEL
+    SSE4
+    CACHE STRING "Instruction set for SIMD code paths.")
+set_property(
+  CACHE SIMD_LEVEL
+  PROPERTY STRINGS
+           "None"
+           "SSE4"
+           "AVX2")
+
 option(ENABLE_IPO "Enable Interprocedural Optimization, aka Link Time Optimization (LTO)" OFF)
 
 if(ENABLE_IPO)
@@ -1,10 +1,12 @@
 #pragma once
 
 #include <cstdint>
+#include <functional>
 
 #include <glm/vec3.hpp>
 
 #include "util/direction.h"
+#include "util/math/math.h"
 #include "util/math/AxisAlignedBox.h"
 
 namespace eng {
@@ -70,4 +72,15 @@ namespace eng {
 	// alias for convenience since const BlockState& function parameters are so commonly used
 	using BlockStateRef = const BlockState&;
 
+}
+
+namespace std {
+	// BlockState hasher
+	template<> struct hash<eng::BlockState> {
+		size_t operator ()(const eng::BlockState& blockState) const noexcept {
+			size_t seed = blockState.getBlockId();
+			eng::hashCombine(seed, hash<eng::BlockState::metadata_t>{}(blockState.getMetadata()));
+			return seed;
+		}
+	};
 }
\ No newline at end of file
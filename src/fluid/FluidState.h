@@ -1,8 +1,10 @@
 #pragma once
 
 #include <cstdint>
+#include <functional>
 
 #include "FluidFlow.h"
+#include "util/math/math.h"
 
 namespace eng {
 
@@ -207,4 +209,15 @@ namespace eng {
 		bool isEmpty() const noexcept;
 	};
 
+}
+
+namespace std {
+	// FluidState hasher
+	template<> struct hash<eng::FluidState> {
+		size_t operator ()(const eng::FluidState& fluidState) const noexcept {
+			size_t seed = fluidState.getFluidId();
+			eng::hashCombine(seed, hash<eng::FluidState::metadata_t>{}(fluidState.getMetadata()));
+			return seed;
+		}
+	};
 }
\ No newline at end of file
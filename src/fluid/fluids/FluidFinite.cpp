@@ -4,6 +4,7 @@
 #include <cmath>
 
 #include "world/World.h"
+#include "world/WorldRegionView.h"
 #include "fluid/FluidRegistry.h"
 #include "block/BlockRegistry.h"
 #include "util/resources/ResourceManager.h"
@@ -65,7 +66,8 @@ namespace eng {
 
 	void FluidFinite::onFluidUpdate(World& world, FluidStateRef fluidState, const glm::ivec3& blockPos, const Direction srcDirection) const {
 		const FiniteFluidState state = fluidState;
-		BlockStateRef blockState = world.getBlockState(blockPos);
+		WorldRegionView region(world, blockPos); // every cell touched here is within 1 block of blockPos
+		BlockStateRef blockState = region.getBlockState(blockPos);
 		
 		const int amount = getAmount(fluidState);
 
@@ -74,14 +76,14 @@ namespace eng {
 		// TODO: pressure
 		
 		const auto dPos = direction::offsetVector(blockPos, Direction::DOWN);
-		FluidStateRef dFluidState = world.getFluidState(dPos);
-		BlockStateRef dBlockState = world.getBlockState(dPos);
+		FluidStateRef dFluidState = region.getFluidState(dPos);
+		BlockStateRef dBlockState = region.getBlockState(dPos);
 		FluidCell dCell(*this, dFluidState, dBlockState, Direction::UP);
 		if (cell.amount > 0) { // flow down
 			const auto flowD = vmin(cell.amount, dCell.capacity - dCell.amount);
 			if (flowD > 0) {
 				dCell.amount += flowD;
-				world.setFluidState(dPos, dCell.toFluidState(*this), true, false, true);
+				region.setFluidState(dPos, dCell.toFluidState(*this), true, false, true);
 				cell.amount -= flowD;
 			}
 		}
@@ -90,14 +92,14 @@ namespace eng {
 			const auto sPos = direction::offsetVector(blockPos, Direction::SOUTH);
 			const auto wPos = direction::offsetVector(blockPos, Direction::WEST);
 			const auto ePos = direction::offsetVector(blockPos, Direction::EAST);
-			FluidStateRef nFluidState = world.getFluidState(nPos);
-			BlockStateRef nBlockState = world.getBlockState(nPos);
-			FluidStateRef sFluidState = world.getFluidState(sPos);
-			BlockStateRef sBlockState = world.getBlockState(sPos);
-			FluidStateRef wFluidState = world.getFluidState(wPos);
-			BlockStateRef wBlockState = world.getBlockState(wPos);
-			FluidStateRef eFluidState = world.getFluidState(ePos);
-			BlockStateRef eBlockState = world.getBlockState(ePos);
+			FluidStateRef nFluidState = region.getFluidState(nPos);
+			BlockStateRef nBlockState = region.getBlockState(nPos);
+			FluidStateRef sFluidState = region.getFluidState(sPos);
+			BlockStateRef sBlockState = region.getBlockState(sPos);
+			FluidStateRef wFluidState = region.getFluidState(wPos);
+			BlockStateRef wBlockState = region.getBlockState(wPos);
+			FluidStateRef eFluidState = region.getFluidState(ePos);
+			BlockStateRef eBlockState = region.getBlockState(ePos);
 			const FluidCell nCellOg(*this, nFluidState, nBlockState, Direction::SOUTH);
 			const FluidCell sCellOg(*this, sFluidState, sBlockState, Direction::NORTH);
 			const FluidCell wCellOg(*this, wFluidState, wBlockState, Direction::EAST);
@@ -121,14 +123,14 @@ namespace eng {
 				const auto sdPos = direction::offsetVector(sPos, Direction::DOWN);
 				const auto wdPos = direction::offsetVector(wPos, Direction::DOWN);
 				const auto edPos = direction::offsetVector(ePos, Direction::DOWN);
-				FluidStateRef ndFluidState = world.getFluidState(ndPos);
-				BlockStateRef ndBlockState = world.getBlockState(ndPos);
-				FluidStateRef sdFluidState = world.getFluidState(sdPos);
-				BlockStateRef sdBlockState = world.getBlockState(sdPos);
-				FluidStateRef wdFluidState = world.getFluidState(wdPos);
-				BlockStateRef wdBlockState = world.getBlockState(wdPos);
-				FluidStateRef edFluidState = world.getFluidState(edPos);
-				BlockStateRef edBlockState = world.getBlockState(edPos);
+				FluidStateRef ndFluidState = region.getFluidState(ndPos);
+				BlockStateRef ndBlockState = region.getBlockState(ndPos);
+				FluidStateRef sdFluidState = region.getFluidState(sdPos);
+				BlockStateRef sdBlockState = region.getBlockState(sdPos);
+				FluidStateRef wdFluidState = region.getFluidState(wdPos);
+				BlockStateRef wdBlockState = region.getBlockState(wdPos);
+				FluidStateRef edFluidState = region.getFluidState(edPos);
+				BlockStateRef edBlockState = region.getBlockState(edPos);
 				const FluidCell ndCell(*this, ndFluidState, ndBlockState, Direction::UP);
 				const FluidCell sdCell(*this, sdFluidState, sdBlockState, Direction::UP);
 				const FluidCell wdCell(*this, wdFluidState, wdBlockState, Direction::UP);
@@ -198,25 +200,25 @@ namespace eng {
 							nCell.amount = vmin(nCell.capacity, avgAmount, flowingTotal);
 							flowingTotal -= nCell.amount;
 							if (nCell.amount != nCellOg.amount)
-								world.setFluidState(nPos, nCell.toFluidState(*this), true, false, true);
+								region.setFluidState(nPos, nCell.toFluidState(*this), true, false, true);
 						}
 						if (doFlowS) {
 							sCell.amount = vmin(sCell.capacity, avgAmount, flowingTotal);
 							flowingTotal -= sCell.amount;
 							if (sCell.amount != sCellOg.amount)
-								world.setFluidState(sPos, sCell.toFluidState(*this), true, false, true);
+								region.setFluidState(sPos, sCell.toFluidState(*this), true, false, true);
 						}
 						if (doFlowW) {
 							wCell.amount = vmin(wCell.capacity, avgAmount, flowingTotal);
 							flowingTotal -= wCell.amount;
 							if (wCell.amount != wCellOg.amount)
-								world.setFluidState(wPos, wCell.toFluidState(*this), true, false, true);
+								region.setFluidState(wPos, wCell.toFluidState(*this), true, false, true);
 						}
 						if (doFlowE) {
 							eCell.amount = vmin(eCell.capacity, avgAmount, flowingTotal);
 							flowingTotal -= eCell.amount;
 							if (eCell.amount != eCellOg.amount)
-								world.setFluidState(ePos, eCell.toFluidState(*this), true, false, true);
+								region.setFluidState(ePos, eCell.toFluidState(*this), true, false, true);
 						}
 						cell.amount = cellReserved + flowingTotal;
 					}
@@ -225,14 +227,14 @@ namespace eng {
 		}
 		if (cell.amount > cell.capacity) { // flow up
 			const auto uPos = direction::offsetVector(blockPos, Direction::UP);
-			FluidStateRef uFluidState = world.getFluidState(uPos);
-			BlockStateRef uBlockState = world.getBlockState(uPos);
+			FluidStateRef uFluidState = region.getFluidState(uPos);
+			BlockStateRef uBlockState = region.getBlockState(uPos);
 			FluidCell uCell(*this, uFluidState, uBlockState, Direction::DOWN);
 
 			const auto flowU = vmin(cell.amount, uCell.capacity - uCell.amount);
 			if (flowU > 0) {
 				uCell.amount += flowU;
-				world.setFluidState(uPos, uCell.toFluidState(*this), true, false, true);
+				region.setFluidState(uPos, uCell.toFluidState(*this), true, false, true);
 				cell.amount -= flowU;
 			}
 		}
@@ -241,9 +243,9 @@ namespace eng {
 		// TODO: update flow direction
 		if (cell.amount != amount) {
 			if (cell.amount == 0)
-				world.setFluidState(blockPos, {}, true, true, false);
+				region.setFluidState(blockPos, {}, true, true, false);
 			else
-				world.setFluidState(blockPos, FiniteFluidState(*this, cell.amount - 1, FluidFlow::Still, state.getMetadata()), true, true, false);
+				region.setFluidState(blockPos, FiniteFluidState(*this, cell.amount - 1, FluidFlow::Still, state.getMetadata()), true, true, false);
 				world.scheduleFluidUpdate(blockPos, Direction::UNDEFINED, 1);
 		}
 	}
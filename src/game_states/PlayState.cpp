@@ -125,8 +125,9 @@ namespace eng {
 		std::cout << glGetString(GL_RENDERER) << '\n';
 
 		// Camera setup
-		const auto terrainHeight = world.getTerrainHeight(0, 0);
-		camera.setPosition(0.5f, terrainHeight + 2.8f, 0.5f);
+		// no chunks are loaded yet, so the spawn is placed above the surface of the terrain density
+		camera.setPosition(0.5f, world.getDensitySurfaceHeight(0, 0) + spawn_eye_height, 0.5f);
+		pendingSpawn = camera.getPosition();
 		//camera.lookAt(0.0f, 0.0f, 0.0f);
 
 		game->inputManager.setCursorMode(input::CursorMode::DISABLED);
@@ -265,11 +266,29 @@ namespace eng {
 
 		world.update();
 
+		if (pendingSpawn) {
+			const ChunkCoord spawnChunkCoord = ChunkCoord::fromBlockPos(static_cast<glm::ivec3>(*pendingSpawn));
+			if (camera.getPosition() != *pendingSpawn) {
+				pendingSpawn.reset(); // the player has moved, so the spawn isn't moved under them
+			} else if (world.isChunkLoaded(spawnChunkCoord) && world.isChunkLoaded(spawnChunkCoord.offset(Direction::UP))) {
+				// the heightmap includes the carvers and decorations that the terrain density doesn't (e.g. trees)
+				if (const auto surfaceHeight = world.getSurfaceHeight(0, 0)) {
+					camera.setPosition(0.5f, *surfaceHeight + spawn_eye_height, 0.5f);
+					pendingSpawn.reset();
+				}
+			}
+		}
+
 		ResourceManager::instance().updateBlockAnimations();
 
 	}
 
 	void PlayState::render(float partialTicks) {
+		const auto renderTime = Game::clock::now();
+		if (prevRenderTime != Game::clock::time_point{})
+			world.reportFrameTime(renderTime - prevRenderTime);
+		prevRenderTime = renderTime;
+
 		worldRenderer.render(partialTicks, *this, &world, &camera);
 
 		hudRenderer.render(partialTicks, *this);
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <chrono>
+#include <optional>
+
 #include <glm/mat4x4.hpp>
 
 #include "GameState.h"
@@ -36,6 +39,12 @@ namespace eng {
 		int fluidPlaceDelay = 0; // TODO: remove
 		int fluidBreakDelay = 0; // TODO: remove
 
+		std::chrono::steady_clock::time_point prevRenderTime {}; // used to measure frame times for the world's chunk load budget
+		// the spawn is placed on the terrain density before any chunk is loaded, and moved onto the generated surface once the chunks around
+		// it load. set until then, or until the player moves away from it
+		std::optional<glm::vec3> pendingSpawn;
+		static constexpr float spawn_eye_height = 2.8f; // blocks between the surface and the camera at the spawn
+
 		const float cameraSpeed = 0.2f;
 		const float cameraSensitivity = 0.5f;
 
@@ -74,6 +83,10 @@ namespace eng {
 
 		const Camera& getCamera() const noexcept { return camera; }
 
+		const World& getWorld() const noexcept { return world; }
+
+		const WorldRenderer& getWorldRenderer() const noexcept { return worldRenderer; }
+
 	private:
 
 		void takeScreenshot() const;
@@ -33,6 +33,9 @@ namespace eng {
 		const glm::vec3& getPosition() const {
 			return position;
 		}
+		const glm::vec3& getPrevPosition() const {
+			return prevPosition;
+		}
 		const glm::vec3& getLookVec() const {
 			return look;
 		}
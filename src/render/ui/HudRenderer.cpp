@@ -9,6 +9,7 @@
 #include <glm/gtx/io.hpp>
 #include <sstream>
 #include <charconv>
+#include <chrono>
 
 namespace eng {
 
@@ -83,6 +84,30 @@ namespace eng {
 			const auto dirStr = "Looking: " + to_string(cameraDir);
 			fontRenderer.drawText(dirStr, glm::vec3(10, 10 + lineHeight, 0), debugInfoFontSize, 0xFFF_c, { 1.0f, 2.5f, 0x000000BF_c });
 		}
+		const auto& loadBudgetState = gameState.getWorld().getChunkLoadBudget().getState();
+		const auto loadBudgetStr = "Chunk loads: "s + std::to_string(loadBudgetState.loadBudget) + "/tick, meshing queue: "s +
+				std::to_string(loadBudgetState.meshingQueueSize) + '/' + std::to_string(loadBudgetState.meshingQueueLimit) +
+				((loadBudgetState.rampingUp) ? " (ramping up)"s : ""s);
+		fontRenderer.drawText(loadBudgetStr, glm::vec3(10, 10 + (2 * lineHeight), 0), debugInfoFontSize, 0xFFF_c, { 1.0f, 2.5f, 0x000000BF_c });
+		const auto missingChunksStr = "Visible chunks missing: "s + std::to_string(gameState.getWorldRenderer().getVisibleChunksMissing());
+		fontRenderer.drawText(missingChunksStr, glm::vec3(10, 10 + (3 * lineHeight), 0), debugInfoFontSize, 0xFFF_c, { 1.0f, 2.5f, 0x000000BF_c });
+		const auto& compressionStats = gameState.getWorld().getChunkCompressionStats();
+		std::ostringstream compressionStream;
+		compressionStream.precision(2);
+		compressionStream << std::fixed << "Chunk data (last sweep): " << (gameState.getWorld().getChunkDataMemoryUsage() >> 20) << " MiB, compressed chunks: " <<
+				compressionStats.compressedChunks << " (" << compressionStats.getCompressionRatio() << ":1), decompression: " <<
+				std::chrono::duration<double, std::micro>(compressionStats.getAverageDecompressionTime()).count() << "us avg, " <<
+				std::chrono::duration<double, std::micro>(compressionStats.maxDecompressionTime).count() << "us max";
+		fontRenderer.drawText(compressionStream.str(), glm::vec3(10, 10 + (4 * lineHeight), 0), debugInfoFontSize, 0xFFF_c, { 1.0f, 2.5f, 0x000000BF_c });
+		const auto heightCacheStats = gameState.getWorld().getTerrainHeightCacheStats();
+		std::ostringstream heightCacheStream;
+		heightCacheStream.precision(1);
+		heightCacheStream << std::fixed << "Terrain height cache: " << heightCacheStats.columns << " columns, " <<
+				(heightCacheStats.getHitRate() * 100.0) << "% hits, " << heightCacheStats.evictions << " evictions";
+		fontRenderer.drawText(heightCacheStream.str(), glm::vec3(10, 10 + (5 * lineHeight), 0), debugInfoFontSize, 0xFFF_c, { 1.0f, 2.5f, 0x000000BF_c });
+		const auto generationStr = "Chunk generation: "s + std::to_string(gameState.getWorld().getGeneratingChunkCount()) + " generating, "s +
+				std::to_string(gameState.getWorld().getProtoChunkCount()) + " proto chunks"s;
+		fontRenderer.drawText(generationStr, glm::vec3(10, 10 + (6 * lineHeight), 0), debugInfoFontSize, 0xFFF_c, { 1.0f, 2.5f, 0x000000BF_c });
 
 		fontRenderer.flush();
 	}
@@ -129,14 +129,17 @@ namespace eng {
 		// create a vector of pointers to all renderable chunks
 		const FrustumF viewFrustum(renderer->getProjectionMatrix() * camera->getViewMatrix(partialTicks), false);
 		for (const auto& [chunkCoord, chunk] : world->getLoadedChunks()) {
-			if (viewFrustum.contains(chunk.getBoundingBox())) { // frustum culling
-				renderableChunks.push_back(&chunk);
-				if (const RenderChunk* renderChunk = chunk.getRawRenderChunk(); renderChunk) {
+			if (!chunk->getSummary().canRender()) continue; // e.g. chunks full of air
+			if (viewFrustum.contains(chunk->getBoundingBox())) { // frustum culling
+				renderableChunks.push_back(chunk);
+				if (const RenderChunk* renderChunk = chunk->getRawRenderChunk(); renderChunk) {
 					renderChunk->preRender(); // keep chunk meshes synchronized
 				}
 			}
 		}
 
+		visibleChunksMissing = countVisibleChunksMissing(viewFrustum, world);
+
 		// render the world
 		renderChunks(partialTicks, gameState, world, camera);
 
@@ -156,6 +159,16 @@ namespace eng {
 		//glDisable(GL_CULL_FACE);
 	}
 
+	size_t WorldRenderer::countVisibleChunksMissing(const FrustumF& viewFrustum, const World* world) {
+		// only the chunks after the world's load cursor can be missing, so once every chunk in range is loaded this checks none
+		size_t missing = 0;
+		world->forEachMissingChunk([&](const ChunkCoord& chunkCoord) {
+			const glm::ivec3 blockPos = ChunkCoord::toBlockPos(chunkCoord);
+			if (viewFrustum.contains(AxisAlignedBox<int>(blockPos, blockPos + static_cast<int>(Chunk::WIDTH)))) missing++;
+		});
+		return missing;
+	}
+
 	void WorldRenderer::resize(const size_t width, const size_t height) {
 		// resize framebuffer attachments
 		worldFBO.bind(FrameBuffer::Target::DRAW_FRAMEBUFFER);
@@ -79,6 +79,8 @@ namespace eng {
 		ShaderProgram transparentsFallbackRevealageShader = ShaderProgram::load("world/blocks.vert", "world/blocks_transparent_fallback_revealage.frag", "world/blocks.geom");
 		ShaderProgram transparentsFBOShader = ShaderProgram::load("world/world_fbo.vert", "world/transparents_fbo.frag");
 
+		size_t visibleChunksMissing = 0; // chunks in the view frustum and in loading range that weren't loaded in the last frame
+
 
 	public:
 		WorldRenderer(Renderer* const);
@@ -91,10 +93,15 @@ namespace eng {
 
 		inline ChunkBakery& getChunkBakery() noexcept { return chunkBakery; }
 
+		// the number of chunks that should have been visible in the last frame, but weren't loaded
+		inline size_t getVisibleChunksMissing() const noexcept { return visibleChunksMissing; }
+
 	private:
 
 		void renderChunks(const float partialTicks, const PlayState& gameState, const World* world, const Camera* camera);
 
+		static size_t countVisibleChunksMissing(const FrustumF& viewFrustum, const World* world);
+
 		void renderBlockSelectionOutline(const float partialTicks, const glm::mat4& mvpMatrix, const Direction selectionFace, AxisAlignedBox<float> selectionBox);
 
 
@@ -9,16 +9,29 @@
 
 namespace eng {
 
-	ChunkBakeData::ChunkBakeData(Chunk& chunk) :
-			blockData(std::make_unique<BlockData>()),
-			fluidData(std::make_unique<FluidData>()),
+	// whether a chunk can't produce any quads
+	static bool isHiddenChunk(const Chunk& chunk, const std::array<const Chunk*, 27>& chunkNeighborhood) {
+		const ChunkSummary& summary = chunk.getSummary();
+		if (!summary.canRender()) return true; // e.g. all air
+		if (summary.hasFluids() || !chunk.isUniform()) return false;
+		if (!chunk.getUniformBlockState().isFullOpaqueCube()) return false;
+		// full opaque cubes are hidden if every face of the chunk is covered by a loaded chunk whose touching face is all opaque cubes
+		constexpr std::array<std::pair<Direction, size_t>, 6> faceNeighbors { {
+			{ Direction::WEST, 4 }, { Direction::EAST, 22 }, { Direction::DOWN, 12 }, { Direction::UP, 14 }, { Direction::NORTH, 10 }, { Direction::SOUTH, 16 },
+		} };
+		return std::all_of(faceNeighbors.begin(), faceNeighbors.end(), [&chunkNeighborhood](const auto& faceNeighbor) -> bool {
+			const Chunk* const c = chunkNeighborhood[faceNeighbor.second];
+			return c && c->getSummary().isFaceOpaque(direction::getOpposite(faceNeighbor.first));
+		});
+	}
+
+	ChunkBakeData::ChunkBakeData(Chunk& chunk, const Chunk::RegionMask regions, const uint32_t version) :
+			regions(regions),
+			version(version),
 			renderChunk(chunk.getRenderChunk()),
 			world(chunk.getWorld()),
 			chunkCoord(chunk.getChunkCoord()),
 			blockPos(chunk.getBlockPos()) {
-		constexpr std::array<int, 3> copyStarts { -static_cast<int>(PADDING), 0, Chunk::WIDTH };
-		constexpr std::array<size_t, 3> copyLengths { PADDING, Chunk::WIDTH, PADDING };
-
 		const std::array<const Chunk*, 27> chunkNeighborhood {
 			world->getChunk(ChunkCoord(chunkCoord + glm::ivec3(-1, -1, -1))),
 			world->getChunk(ChunkCoord(chunkCoord + glm::ivec3(-1,  0, -1))),
@@ -49,27 +62,63 @@ namespace eng {
 			world->getChunk(ChunkCoord(chunkCoord + glm::ivec3( 1,  1,  1))),
 		};
 
+		if (isHiddenChunk(chunk, chunkNeighborhood)) {
+			hidden = true;
+			return;
+		}
+		for (size_t n = 0; n < chunkNeighborhood.size(); n++) {
+			if (const Chunk* const c = chunkNeighborhood[n]; c) {
+				blockSnapshots[n] = c->getBlockDataSnapshot();
+				fluidSnapshots[n] = c->getFluidDataSnapshot();
+			}
+		}
+	}
+
+	void ChunkBakeData::unpack() {
+		if (hidden || blockData) return;
+
+		constexpr std::array<int, 3> copyStarts { -static_cast<int>(PADDING), 0, Chunk::WIDTH };
+		constexpr std::array<size_t, 3> copyLengths { PADDING, Chunk::WIDTH, PADDING };
+
+		// the copy loop below copies contiguous x rows out of each chunk
+		static_assert(Chunk::BlockData::getDataOrder() == ChunkDataOrder::ZYX && Chunk::FluidData::getDataOrder() == ChunkDataOrder::ZYX);
+
+		blockData = std::make_unique<BlockData>();
+		fluidData = std::make_unique<FluidData>();
+
+		// only the rows within PADDING blocks of the remeshed sub-regions are read while meshing
+		glm::ivec3 minPos { Chunk::WIDTH, Chunk::WIDTH, Chunk::WIDTH };
+		glm::ivec3 maxPos { 0, 0, 0 };
+		for (size_t r = 0; r < Chunk::REGION_COUNT; r++) {
+			if (regions & (Chunk::RegionMask{1} << r)) {
+				const glm::ivec3 origin = Chunk::getRegionOrigin(r);
+				minPos = vec_min(minPos, origin);
+				maxPos = vec_max(maxPos, origin + static_cast<int>(Chunk::REGION_WIDTH));
+			}
+		}
+		const int minY = minPos.y - static_cast<int>(PADDING), maxY = maxPos.y + static_cast<int>(PADDING);
+		const int minZ = minPos.z - static_cast<int>(PADDING), maxZ = maxPos.z + static_cast<int>(PADDING);
+
 		for (int ix = 0; ix < 3; ix++) {
 			const int x = copyStarts[ix];
-			for (int z = -static_cast<int>(PADDING); z < static_cast<int>(Chunk::WIDTH + PADDING); z++) {
-				for (int y = -static_cast<int>(PADDING); y < static_cast<int>(Chunk::WIDTH + PADDING); y++) {
-					//const glm::ivec3 cOff { ix - 1, ((y + Chunk::WIDTH) / Chunk::WIDTH) - 1, ((z + Chunk::WIDTH) / Chunk::WIDTH) - 1 };
+			for (int z = minZ; z < maxZ; z++) {
+				for (int y = minY; y < maxY; y++) {
 					const int iz = ((z + Chunk::WIDTH) / Chunk::WIDTH);
 					const int iy = ((y + Chunk::WIDTH) / Chunk::WIDTH);
 					const auto cOff = (ix * 9) + (iz * 3) + iy;
-					const Chunk* const c = chunkNeighborhood[cOff];
-					if (c) {
+					if (blockSnapshots[cOff]) {
 						const auto meshDataI = posToIndex(x, y, z);
 						const auto chunkI = Chunk::posToIndex((x + Chunk::WIDTH) % Chunk::WIDTH, (y + Chunk::WIDTH) % Chunk::WIDTH, (z + Chunk::WIDTH) % Chunk::WIDTH);
-						const auto copyLenBlock = copyLengths[ix] * sizeof(BlockState);
-						const auto copyLenFluid = copyLengths[ix] * sizeof(FluidState);
-						std::memcpy(blockData->data() + meshDataI, c->getBlockData().data() + chunkI, copyLenBlock);
-						std::memcpy(fluidData->data() + meshDataI, c->getFluidData().data() + chunkI, copyLenFluid);
+						blockSnapshots[cOff]->copyTo(chunkI, copyLengths[ix], blockData->data() + meshDataI);
+						fluidSnapshots[cOff]->copyTo(chunkI, copyLengths[ix], fluidData->data() + meshDataI);
 					}
 				}
 			}
 		}
+
+		blockSnapshots = {};
+		fluidSnapshots = {};
 	}
 
 
-}
\ No newline at end of file
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <memory>
+#include <array>
 
 #include <glm/vec3.hpp>
 
@@ -15,6 +16,9 @@ namespace eng {
 	 * - all blockstates & fluidstates within the bounding box of the chunk, expanded 2 blocks in each direction
 	 * - any extended blockstate data // TODO: implement
 	 * - position of the chunk
+	 * On construction only copy-on-write snapshots of the chunk and its 26 neighbors are captured,
+	 * the padded block and fluid arrays are filled in by unpack() on the meshing thread.
+	 * Uniform chunks that can't produce any quads (e.g. all air, or all stone surrounded by stone) don't capture any data
 	 */
 	class ChunkBakeData {
 	public:
@@ -26,6 +30,12 @@ namespace eng {
 		using BlockData = ChunkData<BlockState, WIDTH>;
 		using FluidData = ChunkData<FluidState, WIDTH>;
 	private:
+		std::array<Chunk::BlockDataSnapshot, 27> blockSnapshots; // indexed by (x * 9) + (z * 3) + y, empty if the neighbor isn't loaded
+		std::array<Chunk::FluidDataSnapshot, 27> fluidSnapshots;
+		bool hidden = false;
+		Chunk::RegionMask regions; // sub-regions of the chunk to remesh
+		uint32_t version = 0;
+
 		std::unique_ptr<BlockData> blockData;
 		std::unique_ptr<FluidData> fluidData;
 
@@ -35,7 +45,7 @@ namespace eng {
 		glm::ivec3 blockPos;
 
 	public:
-		explicit ChunkBakeData(Chunk& chunk);
+		explicit ChunkBakeData(Chunk& chunk, Chunk::RegionMask regions = Chunk::ALL_REGIONS, uint32_t version = 0);
 
 		ChunkBakeData(const ChunkBakeData&) = delete;
 		ChunkBakeData(ChunkBakeData&&) = default;
@@ -56,6 +66,18 @@ namespace eng {
 
 		inline const World* getWorld() const noexcept { return world; } // TODO: remove?
 
+		// true if the chunk can't produce any quads, in which case no block or fluid data was captured
+		inline bool isEmpty() const noexcept { return hidden; }
+
+		// copies the captured snapshots into the padded block and fluid arrays, and releases the snapshots
+		// only the parts of the arrays around the sub-regions being remeshed are filled in
+		// must be called before getBlockData, getFluidData, getBlockState, or getFluidState
+		void unpack();
+
+		inline Chunk::RegionMask getRegions() const noexcept { return regions; }
+		inline void addRegions(const Chunk::RegionMask r) noexcept { regions |= r; }
+		inline uint32_t getVersion() const noexcept { return version; }
+
 		inline const ChunkCoord& getChunkCoord() const noexcept { return chunkCoord; }
 		inline const glm::ivec3& getBlockPos() const noexcept { return blockPos; }
 
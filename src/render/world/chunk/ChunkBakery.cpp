@@ -43,7 +43,20 @@ namespace eng {
 		}
 	}
 
-	void ChunkBakery::enqueueTask(Chunk& chunk, const MeshingPriority priority, const bool fluidOnly) {
+	void ChunkBakery::enqueueTask(Chunk& chunk, const MeshingPriority priority, bool fluidOnly, Chunk::RegionMask regions) {
+		if (!chunk.meshed) { // the existing mesh is empty, so every part of it has to be baked
+			regions = Chunk::ALL_REGIONS;
+			fluidOnly = false;
+		}
+		ChunkBakeData chunkData { chunk, regions, chunk.meshVersion + 1 };
+		if (chunkData.isEmpty()) {
+			if (!chunk.meshed) return; // nothing to bake, and no existing mesh to clear
+			chunk.meshed = false;
+		} else {
+			chunk.meshed = true;
+		}
+		chunk.meshVersion++;
+
 		std::scoped_lock<std::mutex> writerLock { taskQueueMutex };
 
 		//std::cout << "chunk bakery task queue size: " << taskQueue.size() << '\n';
@@ -66,8 +79,9 @@ namespace eng {
 			return chunk.getChunkCoord() == task.getChunkCoord();
 		});
 		if (existingIt != taskQueue.end()) {
+			chunkData.addRegions(existingIt->chunkData.getRegions()); // the new task replaces the existing one
 			if (existingIt->priority <= priority) {
-				existingIt->chunkData = ChunkBakeData { chunk };
+				existingIt->chunkData = std::move(chunkData);
 				existingIt->fluidOnly &= fluidOnly;
 				//condVar.notify_one(); // TODO: notify condition variable?
 				return;
@@ -82,7 +96,7 @@ namespace eng {
 				break;
 			}
 		}
-		taskQueue.emplace(insertionIt, chunk, priority, fluidOnly);
+		taskQueue.emplace(insertionIt, std::move(chunkData), priority, fluidOnly);
 		condVar.notify_one();
 	}
 
@@ -112,96 +126,102 @@ namespace eng {
 
 	void ChunkBakery::bakeChunk(ChunkBakeData& chunkData, bool fluidOnly) {
 		if (std::shared_ptr<RenderChunk> renderChunk = chunkData.getRenderChunk(); renderChunk) {
+			if (chunkData.isEmpty()) { // the chunk can't produce any quads, so just clear the existing mesh
+				std::scoped_lock<std::mutex> meshLock { renderChunk->getMeshMutex() };
+				renderChunk->getMesh().clearRegions(chunkData.getVersion());
+				renderChunk->markDirty();
+				return;
+			}
+
+			chunkData.unpack();
 			const MeshingWorldView worldView(chunkData);
 
-			for (size_t j = 0; j < Chunk::SIZE; j++) {
-				const glm::ivec3 pos = Chunk::indexToPos(j);
-				const auto index = ChunkBakeData::posToIndex(pos);
-
-				if (!fluidOnly) { // Block
-					const BlockState& blockState = chunkData.getBlockData()[index];
-					BlockRef block = blockState.getBlock();
-					if (block.hasModel(blockState)) {
-						const glm::ivec3 worldPos = pos + chunkData.getBlockPos();
-
-						// face quads
-						for (const Direction face : direction::directions) {
-							const glm::ivec3 nPos = offsetVector(pos, face);
-							const auto& nState = chunkData.getBlockData()[ChunkBakeData::posToIndex(nPos)];
-							const bool cullFace = nState.getBlock().canCullAdjacentFace(nState, getOpposite(face), blockState);
-							if (!cullFace)
-								for (const auto layer : render_layer::layers) {
-									const auto layerIndex = render_layer::getIndex(layer);
-									block.addFaceQuadsToBuffer(blockState, worldPos, face, layer, pos, worldView, blockScratchBuffers[layerIndex]);
-								}
-						}
-						// non-face quads
-						for (const auto layer : render_layer::layers) {
-							const auto layerIndex = render_layer::getIndex(layer);
-							block.addFaceQuadsToBuffer(blockState, worldPos, Direction::UNDEFINED, layer, pos, worldView, blockScratchBuffers[layerIndex]);
+			const Chunk::RegionMask regions = chunkData.getRegions();
+			std::array<ChunkMesh::region_quad_counts, render_layer::layers.size()> blockRegionCounts {};
+			std::array<ChunkMesh::region_quad_counts, render_layer::layers.size()> fluidRegionCounts {};
+
+			// quads are generated one sub-region at a time, so that the quads of each sub-region are contiguous
+			for (size_t r = 0; r < Chunk::REGION_COUNT; r++) {
+				if (!(regions & (Chunk::RegionMask{1} << r))) continue;
+				std::array<size_t, render_layer::layers.size()> blockStarts, fluidStarts;
+				for (size_t l = 0; l < render_layer::layers.size(); l++) {
+					blockStarts[l] = blockScratchBuffers[l].size();
+					fluidStarts[l] = fluidScratchBuffers[l].size();
+				}
+
+				const glm::ivec3 regionOrigin = Chunk::getRegionOrigin(r);
+				for (size_t j = 0; j < (Chunk::REGION_WIDTH * Chunk::REGION_WIDTH * Chunk::REGION_WIDTH); j++) {
+					const glm::ivec3 pos = regionOrigin + glm::ivec3(
+						j % Chunk::REGION_WIDTH,
+						(j / Chunk::REGION_WIDTH) % Chunk::REGION_WIDTH,
+						j / (Chunk::REGION_WIDTH * Chunk::REGION_WIDTH));
+					const auto index = ChunkBakeData::posToIndex(pos);
+
+					if (!fluidOnly) { // Block
+						const BlockState& blockState = chunkData.getBlockData()[index];
+						BlockRef block = blockState.getBlock();
+						if (block.hasModel(blockState)) {
+							const glm::ivec3 worldPos = pos + chunkData.getBlockPos();
+
+							// face quads
+							for (const Direction face : direction::directions) {
+								const glm::ivec3 nPos = offsetVector(pos, face);
+								const auto& nState = chunkData.getBlockData()[ChunkBakeData::posToIndex(nPos)];
+								const bool cullFace = nState.getBlock().canCullAdjacentFace(nState, getOpposite(face), blockState);
+								if (!cullFace)
+									for (const auto layer : render_layer::layers) {
+										const auto layerIndex = render_layer::getIndex(layer);
+										block.addFaceQuadsToBuffer(blockState, worldPos, face, layer, pos, worldView, blockScratchBuffers[layerIndex]);
+									}
+							}
+							// non-face quads
+							for (const auto layer : render_layer::layers) {
+								const auto layerIndex = render_layer::getIndex(layer);
+								block.addFaceQuadsToBuffer(blockState, worldPos, Direction::UNDEFINED, layer, pos, worldView, blockScratchBuffers[layerIndex]);
+							}
 						}
 					}
-				}
 
-				{ // Fluid
-					const FluidState& fluidState = chunkData.getFluidData()[index];
-					FluidRef fluid = fluidState.getFluid();
-					if (!fluid.isNullFluid(fluidState)) {
-						const glm::ivec3 worldPos = pos + chunkData.getBlockPos();
-						for (auto layer : render_layer::layers) {
-							const auto layerIndex = render_layer::getIndex(layer);
-							fluid.addQuadsToBuffer(fluidState, worldPos, layer, pos, worldView, fluidScratchBuffers[layerIndex]);
+					{ // Fluid
+						const FluidState& fluidState = chunkData.getFluidData()[index];
+						FluidRef fluid = fluidState.getFluid();
+						if (!fluid.isNullFluid(fluidState)) {
+							const glm::ivec3 worldPos = pos + chunkData.getBlockPos();
+							for (auto layer : render_layer::layers) {
+								const auto layerIndex = render_layer::getIndex(layer);
+								fluid.addQuadsToBuffer(fluidState, worldPos, layer, pos, worldView, fluidScratchBuffers[layerIndex]);
+							}
 						}
 					}
 				}
+
+				for (size_t l = 0; l < render_layer::layers.size(); l++) {
+					blockRegionCounts[l][r] = static_cast<uint32_t>(blockScratchBuffers[l].size() - blockStarts[l]);
+					fluidRegionCounts[l][r] = static_cast<uint32_t>(fluidScratchBuffers[l].size() - fluidStarts[l]);
+				}
 			}
 
-			std::scoped_lock<std::mutex> meshLock { renderChunk->getMeshMutex() };
-			ChunkMesh& chunkMesh = renderChunk->getMesh();
-			for (const RenderLayer layer : render_layer::layers) {
-				const auto layerIndex = render_layer::getIndex(layer);
-				if (fluidOnly) {
-					const auto blockQuadCount = chunkMesh.blockQuadCounts[layerIndex];
-					const auto totalQuads = blockQuadCount + fluidScratchBuffers[layerIndex].size();
-					if (totalQuads > 0) {
-						if (chunkMesh.layerQuads[layerIndex].capacity() == 0) {
-							chunkMesh.layerQuads[layerIndex] = ChunkMesh::getPooledQuadList(totalQuads);
-						} else {
-							chunkMesh.layerQuads[layerIndex].resize(blockQuadCount);
-						}
-						chunkMesh.layerQuads[layerIndex].insert(
-							chunkMesh.layerQuads[layerIndex].end(),
-							fluidScratchBuffers[layerIndex].begin(),
-							fluidScratchBuffers[layerIndex].end());
-					} else {
-						ChunkMesh::poolQuadList(chunkMesh.layerQuads[layerIndex]);
-					}
-				} else {
-					const auto blockQuadCount = blockScratchBuffers[layerIndex].size();
-					const auto totalQuads = blockQuadCount + fluidScratchBuffers[layerIndex].size();
-					chunkMesh.blockQuadCounts[layerIndex] = blockQuadCount;
-					if (totalQuads > 0) {
-						if (chunkMesh.layerQuads[layerIndex].capacity() == 0) {
-							chunkMesh.layerQuads[layerIndex] = ChunkMesh::getPooledQuadList(totalQuads);
-						} else {
-							chunkMesh.layerQuads[layerIndex].clear();
-						}
-						chunkMesh.layerQuads[layerIndex].insert(
-							chunkMesh.layerQuads[layerIndex].begin(),
-							blockScratchBuffers[layerIndex].begin(),
-							blockScratchBuffers[layerIndex].end());
-						chunkMesh.layerQuads[layerIndex].insert(
-							chunkMesh.layerQuads[layerIndex].end(),
-							fluidScratchBuffers[layerIndex].begin(),
-							fluidScratchBuffers[layerIndex].end());
-					} else {
-						ChunkMesh::poolQuadList(chunkMesh.layerQuads[layerIndex]);
+			{
+				std::scoped_lock<std::mutex> meshLock { renderChunk->getMeshMutex() };
+				ChunkMesh& chunkMesh = renderChunk->getMesh();
+				// sub-regions that were already remeshed by a newer task keep their current quads
+				const Chunk::RegionMask blockRegions = fluidOnly ? 0 : chunkMesh.claimBlockRegions(regions, chunkData.getVersion());
+				const Chunk::RegionMask fluidRegions = chunkMesh.claimFluidRegions(regions, chunkData.getVersion());
+				if (blockRegions || fluidRegions) {
+					for (const RenderLayer layer : render_layer::layers) {
+						const auto layerIndex = render_layer::getIndex(layer);
+						chunkMesh.spliceRegions(layerIndex, regions,
+							blockRegions, blockScratchBuffers[layerIndex], blockRegionCounts[layerIndex],
+							fluidRegions, fluidScratchBuffers[layerIndex], fluidRegionCounts[layerIndex]);
 					}
+					renderChunk->markDirty();
 				}
+			}
+			for (const RenderLayer layer : render_layer::layers) {
+				const auto layerIndex = render_layer::getIndex(layer);
 				blockScratchBuffers[layerIndex].clear();
 				fluidScratchBuffers[layerIndex].clear();
 			}
-			renderChunk->markDirty();
 		}
 	}
 
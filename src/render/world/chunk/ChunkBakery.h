@@ -55,7 +55,8 @@ namespace eng {
 
 		// TODO: add a method to enqueue multiple tasks at once???
 
-		void enqueueTask(Chunk& chunk, const MeshingPriority priority, bool fluidOnly);
+		// regions are the sub-regions of the chunk to remesh, the rest of the chunk's mesh is kept
+		void enqueueTask(Chunk& chunk, const MeshingPriority priority, bool fluidOnly, Chunk::RegionMask regions = Chunk::ALL_REGIONS);
 
 		size_t queuedTasks() const;
 
@@ -3,6 +3,7 @@
 #include <type_traits>
 #include <utility>
 #include <mutex>
+#include <algorithm>
 
 namespace eng {
 
@@ -46,6 +47,11 @@ namespace eng {
 		b.getLayerSize(render_layer::layers[1]),
 		b.getLayerSize(render_layer::layers[2])
 	) {
+		blockQuadCounts = b.blockQuadCounts;
+		blockRegionQuadCounts = b.blockRegionQuadCounts;
+		fluidRegionQuadCounts = b.fluidRegionQuadCounts;
+		blockRegionVersions = b.blockRegionVersions;
+		fluidRegionVersions = b.fluidRegionVersions;
 		for (const auto layer : render_layer::layers) {
 			auto& l = getQuads(layer), bl = b.getQuads(layer);
 			l.insert(l.begin(), bl.begin(), bl.end()); // copy contents of quad lists
@@ -53,10 +59,20 @@ namespace eng {
 	}
 	ChunkMesh::ChunkMesh(ChunkMesh&& b) : ChunkMesh() {
 		std::swap(this->layerQuads, b.layerQuads);
+		blockQuadCounts = b.blockQuadCounts;
+		blockRegionQuadCounts = b.blockRegionQuadCounts;
+		fluidRegionQuadCounts = b.fluidRegionQuadCounts;
+		blockRegionVersions = b.blockRegionVersions;
+		fluidRegionVersions = b.fluidRegionVersions;
 	}
 
 	ChunkMesh& ChunkMesh::operator =(const ChunkMesh& b) {
 		if (&b != this) {
+			blockQuadCounts = b.blockQuadCounts;
+			blockRegionQuadCounts = b.blockRegionQuadCounts;
+			fluidRegionQuadCounts = b.fluidRegionQuadCounts;
+			blockRegionVersions = b.blockRegionVersions;
+			fluidRegionVersions = b.fluidRegionVersions;
 			for (const auto layer : render_layer::layers) {
 				auto& l = getQuads(layer), bl = b.getQuads(layer);
 				if (bl.empty()) {
@@ -71,14 +87,84 @@ namespace eng {
 		return *this;
 	}
 	ChunkMesh& ChunkMesh::operator =(ChunkMesh&& b) {
-		if (&b != this)
+		if (&b != this) {
 			std::swap(this->layerQuads, b.layerQuads);
+			std::swap(blockQuadCounts, b.blockQuadCounts);
+			std::swap(blockRegionQuadCounts, b.blockRegionQuadCounts);
+			std::swap(fluidRegionQuadCounts, b.fluidRegionQuadCounts);
+			std::swap(blockRegionVersions, b.blockRegionVersions);
+			std::swap(fluidRegionVersions, b.fluidRegionVersions);
+		}
 		return *this;
 	}
 	
 	void ChunkMesh::clear() {
 		for (auto& l : layerQuads)
 			l.clear();
+		blockQuadCounts = {};
+		blockRegionQuadCounts = {};
+		fluidRegionQuadCounts = {};
+	}
+
+	void ChunkMesh::clearRegions(const uint32_t version) {
+		for (auto& l : layerQuads)
+			poolQuadList(l);
+		blockQuadCounts = {};
+		blockRegionQuadCounts = {};
+		fluidRegionQuadCounts = {};
+		for (auto& v : blockRegionVersions) v = std::max(v, version);
+		for (auto& v : fluidRegionVersions) v = std::max(v, version);
+	}
+
+	static chunk_region_mask claimRegions(std::array<uint32_t, chunk_region_count>& regionVersions, const chunk_region_mask regions, const uint32_t version) {
+		chunk_region_mask claimed = 0;
+		for (size_t r = 0; r < chunk_region_count; r++) {
+			const chunk_region_mask bit = chunk_region_mask{1} << r;
+			if ((regions & bit) && (regionVersions[r] < version)) {
+				regionVersions[r] = version;
+				claimed |= bit;
+			}
+		}
+		return claimed;
+	}
+	chunk_region_mask ChunkMesh::claimBlockRegions(const chunk_region_mask regions, const uint32_t version) {
+		return claimRegions(blockRegionVersions, regions, version);
+	}
+	chunk_region_mask ChunkMesh::claimFluidRegions(const chunk_region_mask regions, const uint32_t version) {
+		return claimRegions(fluidRegionVersions, regions, version);
+	}
+
+	// appends the quads of each region from either the old quads or the new quads to dst, and updates the region counts
+	static void spliceQuads(ChunkMesh::quad_list& dst, const ChunkMesh::quad_list& oldQuads, size_t oldOffset, ChunkMesh::region_quad_counts& counts,
+			const chunk_region_mask bakedRegions, const chunk_region_mask replacedRegions, const ChunkMesh::quad_list& newQuads, const ChunkMesh::region_quad_counts& newCounts) {
+		size_t newOffset = 0;
+		for (size_t r = 0; r < chunk_region_count; r++) {
+			const chunk_region_mask bit = chunk_region_mask{1} << r;
+			const size_t oldCount = counts[r];
+			if (replacedRegions & bit) {
+				dst.insert(dst.end(), newQuads.begin() + newOffset, newQuads.begin() + newOffset + newCounts[r]);
+				counts[r] = newCounts[r];
+			} else {
+				dst.insert(dst.end(), oldQuads.begin() + oldOffset, oldQuads.begin() + oldOffset + oldCount);
+			}
+			oldOffset += oldCount;
+			if (bakedRegions & bit) newOffset += newCounts[r];
+		}
+	}
+
+	void ChunkMesh::spliceRegions(const size_t layerIndex, const chunk_region_mask bakedRegions,
+			const chunk_region_mask blockRegions, const quad_list& blockQuads, const region_quad_counts& blockCounts,
+			const chunk_region_mask fluidRegions, const quad_list& fluidQuads, const region_quad_counts& fluidCounts) {
+		quad_list& oldQuads = layerQuads[layerIndex];
+		const size_t oldBlockQuads = blockQuadCounts[layerIndex];
+		quad_list quads = getPooledQuadList(oldQuads.size() + blockQuads.size() + fluidQuads.size());
+		quads.clear();
+		spliceQuads(quads, oldQuads, 0, blockRegionQuadCounts[layerIndex], bakedRegions, blockRegions, blockQuads, blockCounts);
+		blockQuadCounts[layerIndex] = quads.size();
+		spliceQuads(quads, oldQuads, oldBlockQuads, fluidRegionQuadCounts[layerIndex], bakedRegions, fluidRegions, fluidQuads, fluidCounts);
+		std::swap(oldQuads, quads);
+		poolQuadList(quads);
+		if (oldQuads.empty()) poolQuadList(oldQuads);
 	}
 
 }
\ No newline at end of file
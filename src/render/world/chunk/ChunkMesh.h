@@ -5,6 +5,7 @@
 
 #include "render/world/RenderLayer.h"
 #include "model/block/BlockQuad.h"
+#include "world/chunk/chunk_consts.h"
 
 
 namespace eng {
@@ -12,15 +13,26 @@ namespace eng {
 	class Chunk;
 	class ChunkBakery;
 
+	/*
+	 * The quads of each layer are stored as all block quads followed by all fluid quads,
+	 * and within each of those the quads are grouped by the chunk sub-region that produced them (in region index order),
+	 * so that the quads of individual sub-regions can be replaced without remeshing the whole chunk.
+	 */
 	class ChunkMesh {
 		friend class Chunk;
 		friend class ChunkBakery;
 	public:
 		using quad_list = std::vector<BlockQuad>;
 		using layered_quad_list = std::array<quad_list, render_layer::layers.size()>;
+		using region_quad_counts = std::array<uint32_t, chunk_region_count>;
 	private:
 		layered_quad_list layerQuads;
-		std::array<size_t, render_layer::layers.size()> blockQuadCounts;
+		std::array<size_t, render_layer::layers.size()> blockQuadCounts {};
+		std::array<region_quad_counts, render_layer::layers.size()> blockRegionQuadCounts {};
+		std::array<region_quad_counts, render_layer::layers.size()> fluidRegionQuadCounts {};
+		// version of the meshing task that last replaced the quads of each sub-region
+		std::array<uint32_t, chunk_region_count> blockRegionVersions {};
+		std::array<uint32_t, chunk_region_count> fluidRegionVersions {};
 
 		static std::vector<quad_list> quadListPool;
 	public:
@@ -66,6 +78,19 @@ namespace eng {
 	private:
 		static quad_list getPooledQuadList(const size_t size);
 		static void poolQuadList(quad_list&);
+
+		// removes all quads, and prevents meshing tasks older than version from adding any
+		void clearRegions(uint32_t version);
+		// returns the sub-regions in regions whose block (or fluid) quads were last replaced by a task older than version,
+		// and marks them as replaced by version
+		chunk_region_mask claimBlockRegions(chunk_region_mask regions, uint32_t version);
+		chunk_region_mask claimFluidRegions(chunk_region_mask regions, uint32_t version);
+		// replaces the quads of some sub-regions of a layer
+		// bakedRegions are the sub-regions that blockQuads and fluidQuads contain quads for (grouped by region, with the counts in blockCounts and fluidCounts),
+		// the block quads of blockRegions and the fluid quads of fluidRegions are replaced, and all other quads are kept
+		void spliceRegions(size_t layerIndex, chunk_region_mask bakedRegions,
+			chunk_region_mask blockRegions, const quad_list& blockQuads, const region_quad_counts& blockCounts,
+			chunk_region_mask fluidRegions, const quad_list& fluidQuads, const region_quad_counts& fluidCounts);
 	};
 
 	inline std::vector<ChunkMesh::quad_list> ChunkMesh::quadListPool {};
@@ -5,6 +5,7 @@
 #include <memory>
 #include <cstring>
 
+#include <zlib.h>
 #include <zstr.hpp>
 
 namespace eng {
@@ -92,4 +93,23 @@ namespace eng {
 		zFileStream.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size_bytes()));
 	}
 
+
+	std::vector<unsigned char> compressBytes(std::span<const unsigned char> bytes, const int level) {
+		uLongf compressedSize = compressBound(static_cast<uLong>(bytes.size()));
+		std::vector<unsigned char> compressed(compressedSize);
+		const int result = compress2(compressed.data(), &compressedSize, bytes.data(), static_cast<uLong>(bytes.size()), level);
+		if (result != Z_OK)
+			throw std::runtime_error("Failed to compress " + std::to_string(bytes.size()) + " bytes (zlib error " + std::to_string(result) + ")");
+		compressed.resize(compressedSize);
+		return compressed;
+	}
+	std::vector<unsigned char> decompressBytes(std::span<const unsigned char> compressedBytes, const size_t uncompressedSize) {
+		std::vector<unsigned char> bytes(uncompressedSize);
+		uLongf size = static_cast<uLongf>(uncompressedSize);
+		const int result = uncompress(bytes.data(), &size, compressedBytes.data(), static_cast<uLong>(compressedBytes.size()));
+		if ((result != Z_OK) || (size != uncompressedSize))
+			throw std::runtime_error("Failed to decompress " + std::to_string(compressedBytes.size()) + " bytes (zlib error " + std::to_string(result) + ")");
+		return bytes;
+	}
+
 }
\ No newline at end of file
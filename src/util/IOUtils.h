@@ -15,6 +15,12 @@ namespace eng {
 	std::vector<unsigned char> readCompressedBinaryFile(const std::string& filePath);
 	void writeCompressedBinaryFile(const std::string& filePath, std::span<const unsigned char> bytes);
 
+	// in-memory zlib compression, for data that is stored inside of other files
+	// level is a zlib compression level (0-9), or -1 for zlib's default level
+	std::vector<unsigned char> compressBytes(std::span<const unsigned char> bytes, int level = -1);
+	// uncompressedSize must be the exact size of the original data
+	std::vector<unsigned char> decompressBytes(std::span<const unsigned char> compressedBytes, size_t uncompressedSize);
+
 
 	// TODO: functions for reading and writing image files
 
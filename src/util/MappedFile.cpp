@@ -0,0 +1,161 @@
+#include "MappedFile.h"
+
+#include <string>
+#include <stdexcept>
+#include <utility>
+#include <cstdint>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <cerrno>
+#include <cstring>
+#endif
+
+namespace eng {
+
+#ifdef _WIN32
+
+	MappedFile::MappedFile(const std::filesystem::path& path) {
+		const HANDLE handle = CreateFileW(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (handle == INVALID_HANDLE_VALUE)
+			throw std::runtime_error("Could not open file at " + path.string());
+		fileHandle = handle;
+		LARGE_INTEGER size;
+		if (!GetFileSizeEx(handle, &size)) {
+			close();
+			throw std::runtime_error("Could not get the size of file at " + path.string());
+		}
+		fileSize = static_cast<size_t>(size.QuadPart);
+		remap();
+	}
+
+	bool MappedFile::isOpen() const noexcept {
+		return fileHandle != nullptr;
+	}
+
+	void MappedFile::remap() {
+		unmap();
+		if (fileSize == 0) return; // empty files can't be mapped
+		mappingHandle = CreateFileMappingW(static_cast<HANDLE>(fileHandle), nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (!mappingHandle)
+			throw std::runtime_error("Could not map file (error " + std::to_string(GetLastError()) + ")");
+		mappedBytes = static_cast<const unsigned char*>(MapViewOfFile(static_cast<HANDLE>(mappingHandle), FILE_MAP_READ, 0, 0, 0));
+		if (!mappedBytes) {
+			unmap();
+			throw std::runtime_error("Could not map file (error " + std::to_string(GetLastError()) + ")");
+		}
+		mappedSize = fileSize;
+	}
+
+	void MappedFile::write(const size_t offset, std::span<const unsigned char> bytes) {
+		OVERLAPPED overlapped {};
+		overlapped.Offset = static_cast<DWORD>(offset & 0xFFFFFFFFull);
+		overlapped.OffsetHigh = static_cast<DWORD>(static_cast<uint64_t>(offset) >> 32);
+		DWORD written = 0;
+		if (!WriteFile(static_cast<HANDLE>(fileHandle), bytes.data(), static_cast<DWORD>(bytes.size()), &written, &overlapped) || (written != bytes.size()))
+			throw std::runtime_error("Could not write to file (error " + std::to_string(GetLastError()) + ")");
+		if ((offset + bytes.size()) > fileSize) fileSize = offset + bytes.size();
+	}
+
+	void MappedFile::unmap() noexcept {
+		if (mappedBytes) UnmapViewOfFile(mappedBytes);
+		if (mappingHandle) CloseHandle(static_cast<HANDLE>(mappingHandle));
+		mappedBytes = nullptr;
+		mappingHandle = nullptr;
+		mappedSize = 0;
+	}
+
+	void MappedFile::close() noexcept {
+		unmap();
+		if (fileHandle) CloseHandle(static_cast<HANDLE>(fileHandle));
+		fileHandle = nullptr;
+		fileSize = 0;
+	}
+
+#else
+
+	MappedFile::MappedFile(const std::filesystem::path& path) {
+		fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+		if (fd < 0)
+			throw std::runtime_error("Could not open file at " + path.string() + ": " + std::strerror(errno));
+		struct stat fileStat;
+		if (::fstat(fd, &fileStat) != 0) {
+			close();
+			throw std::runtime_error("Could not get the size of file at " + path.string() + ": " + std::strerror(errno));
+		}
+		fileSize = static_cast<size_t>(fileStat.st_size);
+		remap();
+	}
+
+	bool MappedFile::isOpen() const noexcept {
+		return fd >= 0;
+	}
+
+	void MappedFile::remap() {
+		unmap();
+		if (fileSize == 0) return; // empty files can't be mapped
+		void* const mapping = ::mmap(nullptr, fileSize, PROT_READ, MAP_SHARED, fd, 0);
+		if (mapping == MAP_FAILED)
+			throw std::runtime_error(std::string("Could not map file: ") + std::strerror(errno));
+		mappedBytes = static_cast<const unsigned char*>(mapping);
+		mappedSize = fileSize;
+	}
+
+	void MappedFile::write(size_t offset, std::span<const unsigned char> bytes) {
+		while (!bytes.empty()) {
+			const ssize_t written = ::pwrite(fd, bytes.data(), bytes.size(), static_cast<off_t>(offset));
+			if (written < 0) {
+				if (errno == EINTR) continue;
+				throw std::runtime_error(std::string("Could not write to file: ") + std::strerror(errno));
+			}
+			offset += static_cast<size_t>(written);
+			bytes = bytes.subspan(static_cast<size_t>(written));
+		}
+		if (offset > fileSize) fileSize = offset;
+	}
+
+	void MappedFile::unmap() noexcept {
+		if (mappedBytes) ::munmap(const_cast<unsigned char*>(mappedBytes), mappedSize);
+		mappedBytes = nullptr;
+		mappedSize = 0;
+	}
+
+	void MappedFile::close() noexcept {
+		unmap();
+		if (fd >= 0) ::close(fd);
+		fd = -1;
+		fileSize = 0;
+	}
+
+#endif
+
+	MappedFile::MappedFile(MappedFile&& b) noexcept {
+		*this = std::move(b);
+	}
+	MappedFile& MappedFile::operator =(MappedFile&& b) noexcept {
+		if (this != &b) {
+			close();
+#ifdef _WIN32
+			fileHandle = std::exchange(b.fileHandle, nullptr);
+			mappingHandle = std::exchange(b.mappingHandle, nullptr);
+#else
+			fd = std::exchange(b.fd, -1);
+#endif
+			mappedBytes = std::exchange(b.mappedBytes, nullptr);
+			mappedSize = std::exchange(b.mappedSize, 0);
+			fileSize = std::exchange(b.fileSize, 0);
+		}
+		return *this;
+	}
+
+	MappedFile::~MappedFile() {
+		close();
+	}
+
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstddef>
+#include <span>
+#include <filesystem>
+
+namespace eng {
+
+	/*
+	 * A file that is read through a read-only memory mapping, and written with positional writes.
+	 * The mapping only covers the file as it was when it was last mapped, so remap() has to be called to read data that was written past its end.
+	 * Writes to the mapped part of the file are visible through the mapping immediately.
+	 */
+	class MappedFile {
+	private:
+#ifdef _WIN32
+		void* fileHandle = nullptr;
+		void* mappingHandle = nullptr;
+#else
+		int fd = -1;
+#endif
+		const unsigned char* mappedBytes = nullptr;
+		size_t mappedSize = 0;
+		size_t fileSize = 0;
+
+	public:
+		MappedFile() noexcept = default;
+		// opens the file for reading and writing, and creates it if it doesn't exist
+		explicit MappedFile(const std::filesystem::path& path);
+
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator =(const MappedFile&) = delete;
+
+		MappedFile(MappedFile&&) noexcept;
+		MappedFile& operator =(MappedFile&&) noexcept;
+
+		~MappedFile();
+
+		bool isOpen() const noexcept;
+
+		inline size_t size() const noexcept { return fileSize; }
+		inline std::span<const unsigned char> getMappedBytes() const noexcept { return { mappedBytes, mappedSize }; }
+
+		// maps the whole file, including any data written since the last time it was mapped
+		void remap();
+
+		// writes bytes at the given offset, extending the file if necessary
+		void write(size_t offset, std::span<const unsigned char> bytes);
+
+	private:
+		void unmap() noexcept;
+		void close() noexcept;
+	};
+
+}
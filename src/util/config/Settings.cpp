@@ -14,6 +14,7 @@ namespace eng {
 
 	void Settings::applyChanges(Game& game) {
 		World::setChunkLoadRadius(chunkLoadRadius);
+		World::setChunkCompression(static_cast<uint64_t>(chunkCompressionDelay) * Game::TICKRATE, static_cast<size_t>(chunkMemoryBudget) << 20);
 		game.renderer.setUIScale(uiScale);
 
 		saveSettingsFile(*this);
@@ -42,6 +43,10 @@ namespace eng {
 			JonkObject& settingsObj = settingsJonk.asObject();
 			if (const auto chunkLoadRad = settingsObj.getOptional<int16_t>("chunk_load_radius"); chunkLoadRad)
 				settings.chunkLoadRadius = std::clamp(*chunkLoadRad, min_chunk_load_radius, max_chunk_load_radius);
+			if (const auto compressionDelay = settingsObj.getOptional<int32_t>("chunk_compression_delay"); compressionDelay)
+				settings.chunkCompressionDelay = std::clamp(*compressionDelay, min_chunk_compression_delay, max_chunk_compression_delay);
+			if (const auto memoryBudget = settingsObj.getOptional<int32_t>("chunk_memory_budget"); memoryBudget)
+				settings.chunkMemoryBudget = std::clamp(*memoryBudget, min_chunk_memory_budget, max_chunk_memory_budget);
 			if (const auto uiScale = settingsObj.getOptional<int32_t>("ui_scale"); uiScale)
 				settings.uiScale = std::clamp(*uiScale, min_ui_scale, max_ui_scale);
 			if (const auto windowSize = settingsObj.getOptional<glm::i16vec2>("window_size"); windowSize)
@@ -14,6 +14,8 @@ namespace eng {
 		static inline constexpr const char* file_path = "settings.jonk";
 
 		static inline constexpr int16_t min_chunk_load_radius = 24, max_chunk_load_radius = 512;
+		static inline constexpr int32_t min_chunk_compression_delay = 1, max_chunk_compression_delay = 3600;
+		static inline constexpr int32_t min_chunk_memory_budget = 0, max_chunk_memory_budget = 65536;
 		static inline constexpr int32_t min_ui_scale = 1, max_ui_scale = 4;
 		static inline constexpr glm::i16vec2 min_window_size { 212, 120 };
 
@@ -21,6 +23,8 @@ namespace eng {
 		int16_t chunkRenderRadius = 192;
 		int16_t lightingRadius = 192;
 		//int16_t chunkUpdateRadius = 192;
+		int32_t chunkCompressionDelay = 30; // seconds that a chunk has to go unaccessed before it can be compressed in memory
+		int32_t chunkMemoryBudget = 256; // MiB of uncompressed chunk data to keep before idle chunks are compressed
 		int32_t uiScale = 2;
 		glm::i16vec2 windowSize { 960, 540 };
 
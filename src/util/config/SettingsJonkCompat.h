@@ -15,6 +15,8 @@ namespace jonk {
 		static Jonk toJonk(const eng::Settings& settings) {
 			JonkObject jonkObj {};
 			jonkObj.emplace("chunk_load_radius", settings.chunkLoadRadius);
+			jonkObj.emplace("chunk_compression_delay", settings.chunkCompressionDelay);
+			jonkObj.emplace("chunk_memory_budget", settings.chunkMemoryBudget);
 			jonkObj.emplace("ui_scale", settings.uiScale);
 			jonkObj.emplace("window_size", settings.windowSize);
 
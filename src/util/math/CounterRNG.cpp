@@ -0,0 +1,62 @@
+#include "CounterRNG.h"
+
+#include "simd.h"
+
+namespace eng {
+
+	// splitmix64's finalizer
+	static constexpr uint64_t mix64(uint64_t x) noexcept {
+		x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+		x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+		return x ^ (x >> 31);
+	}
+
+	CounterRNG::CounterRNG(const seed_t seed, const uint64_t feature, const glm::ivec3& position) noexcept {
+		constexpr uint64_t golden_gamma = 0x9e3779b97f4a7c15ull;
+		uint64_t key = mix64(seed + (feature * golden_gamma));
+		key = mix64(key + static_cast<uint32_t>(position.x));
+		key = mix64(key + static_cast<uint32_t>(position.y));
+		key = mix64(key + static_cast<uint32_t>(position.z));
+		key0 = static_cast<uint32_t>(key);
+		key1 = static_cast<uint32_t>(key >> 32);
+	}
+
+	// the same hash as getUint32, on every lane of a batch
+	template<typename Batch>
+	static inline Batch mixBatch(Batch x) noexcept {
+		x = x ^ (x >> 16);
+		x = x * Batch::broadcast(0x85ebca6bu);
+		x = x ^ (x >> 13);
+		x = x * Batch::broadcast(0xc2b2ae35u);
+		return x ^ (x >> 16);
+	}
+
+	// the numbers at counters first, first + 1, ... in successive lanes
+	template<typename Batch>
+	static inline Batch hashCounters(const uint32_t first, const uint32_t key0, const uint32_t key1) noexcept {
+		return mixBatch(mixBatch(Batch::sequence(first) + Batch::broadcast(key0)) ^ Batch::broadcast(key1));
+	}
+
+	// calls store(i, numbers) for each batch of the numbers at counters [firstCounter, firstCounter + size), where i is the index of the first one
+	template<typename F>
+	static void fillCounters(const uint32_t firstCounter, const size_t size, const uint32_t key0, const uint32_t key1, F&& store) noexcept {
+		size_t i = 0;
+		for (; (i + simd::uint32_batch::size) <= size; i += simd::uint32_batch::size)
+			store(i, hashCounters<simd::uint32_batch>(firstCounter + static_cast<uint32_t>(i), key0, key1));
+		for (; i < size; i++)
+			store(i, hashCounters<simd::uint32_scalar>(firstCounter + static_cast<uint32_t>(i), key0, key1));
+	}
+
+	void CounterRNG::fillUint32(const counter_t firstCounter, const std::span<uint32_t> out) const noexcept {
+		fillCounters(firstCounter, out.size(), key0, key1, [&](const size_t i, const auto numbers) {
+			numbers.store(out.data() + i);
+		});
+	}
+
+	void CounterRNG::fillFloat(const counter_t firstCounter, const std::span<float> out) const noexcept {
+		fillCounters(firstCounter, out.size(), key0, key1, [&](const size_t i, const auto numbers) {
+			(numbers >> 8).storeFloat(out.data() + i, float_scale);
+		});
+	}
+
+}
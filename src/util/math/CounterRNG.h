@@ -0,0 +1,69 @@
+#pragma once
+
+#include <span>
+#include <cstdint>
+
+#include <glm/vec3.hpp>
+
+#include "RNG.h"
+
+/*
+ *  Counter-based random number generator, for generation that has to give the same results in any order and on any thread
+ *  Each number is a hash of a key and a counter, so the numbers of a stream can be drawn in any order (or all at once with the fill methods)
+ *  https://www.thesalmons.org/john/random123/papers/random123sc11.pdf
+ */
+
+namespace eng {
+
+	class CounterRNG {
+	public:
+		using seed_t = RNG::seed_t;
+		using counter_t = uint32_t;
+
+	private:
+		// the key of the stream, split into the two 32-bit words that are mixed into each counter
+		uint32_t key0;
+		uint32_t key1;
+
+	public:
+		// the stream of numbers for a feature (e.g. trees or tall grass) at a position (e.g. a chunk coordinate)
+		[[nodiscard]] CounterRNG(seed_t seed, uint64_t feature, const glm::ivec3& position) noexcept;
+
+		// returns the random 32-bit unsigned integer at counter
+		[[nodiscard]] inline uint32_t getUint32(const counter_t counter) const noexcept {
+			return mix(mix(counter + key0) ^ key1);
+		}
+		// returns a random 32-bit unsigned integer in the range [0, bound)
+		// the bias towards small results is at most bound / 2^32, which is negligible for the small bounds generation uses
+		[[nodiscard]] inline uint32_t getUint32(const counter_t counter, const uint32_t bound) const noexcept {
+			return static_cast<uint32_t>((static_cast<uint64_t>(getUint32(counter)) * bound) >> 32);
+		}
+		// returns a random 32-bit unsigned integer in the range [min, bound)
+		[[nodiscard]] inline uint32_t getUint32(const counter_t counter, const uint32_t min, const uint32_t bound) const noexcept {
+			return min + getUint32(counter, bound - min);
+		}
+		// returns a random float between 0 (inclusive) and 1 (exclusive)
+		[[nodiscard]] inline float getFloat(const counter_t counter) const noexcept {
+			return static_cast<float>(getUint32(counter) >> 8) * float_scale;
+		}
+
+		// fills out with the numbers at counters [firstCounter, firstCounter + out.size()), the same as calling getUint32 for each
+		void fillUint32(counter_t firstCounter, std::span<uint32_t> out) const noexcept;
+		// fills out with the numbers at counters [firstCounter, firstCounter + out.size()), the same as calling getFloat for each
+		void fillFloat(counter_t firstCounter, std::span<float> out) const noexcept;
+
+	private:
+		static constexpr float float_scale = 1.0f / static_cast<float>(1u << 24); // floats are made from the top 24 bits
+
+		// murmur3's 32-bit finalizer
+		static inline constexpr uint32_t mix(uint32_t x) noexcept {
+			x ^= x >> 16;
+			x *= 0x85ebca6bu;
+			x ^= x >> 13;
+			x *= 0xc2b2ae35u;
+			x ^= x >> 16;
+			return x;
+		}
+	};
+
+}
@@ -1,12 +1,20 @@
 #include "NoiseGen.h"
 
 #include <array>
+#include <vector>
 #include <limits>
 #include <type_traits>
+#include <algorithm>
+#include <numeric>
+#include <utility>
+#include <stdexcept>
+#include <cmath>
 
 #include <glm/common.hpp>
 #include <glm/geometric.hpp>
 
+#include "simd.h"
+
 namespace eng {
 
 	template<typename T>
@@ -36,8 +44,22 @@ namespace eng {
 		glm::vec<3, T> {  0.0, -1.0, -1.0 },
 	};
 
-	NoiseGen::NoiseGen(const RNG::seed_t seed, const NoiseParams& params) noexcept :
-			defaultParams(params), seed(seed) {}
+	NoiseGen::NoiseGen(const RNG::seed_t seed, const NoiseParams& params, const GradientMode gradientMode) noexcept :
+			defaultParams(params), seed(seed), gradientMode(gradientMode) {
+		if (gradientMode == GradientMode::Permutation) permutation = PermutationTable(seed);
+	}
+
+	NoiseGen::PermutationTable::PermutationTable(const RNG::seed_t seed) {
+		std::array<uint16_t, size> values;
+		std::iota(values.begin(), values.end(), uint16_t { 0 });
+		RNG rand(seed);
+		for (size_t i = size - 1; i > 0; i--) // Fisher-Yates shuffle
+			std::swap(values[i], values[rand.nextUint32(static_cast<uint32_t>(i + 1))]);
+		for (size_t i = 0; i < perm.size(); i++) {
+			perm[i] = values[i & (size - 1)];
+			gradients3d[i] = static_cast<uint8_t>(perm[i] % vecPool3d<double>.size());
+		}
+	}
 
 
 	template<typename T>
@@ -97,50 +119,75 @@ namespace eng {
 		return vecPool3d<T>[RNG(hash(seed, pos)).nextUint32(vecPool3d<T>.size())];
 	}
 
-	template<typename T, std::enable_if_t<std::numeric_limits<T>::is_iec559, int> = 0>
-	static T getOctave(const glm::ivec2& pos, const T frequency, const RNG::seed_t seed) {
+	// picks the gradient of a lattice point by hashing it with the seed (GradientMode::Hashed)
+	struct HashedGradients {
+		RNG::seed_t seed;
+
+		inline glm::dvec2 operator ()(const glm::ivec2& pos) const { return getGradient<double>(pos, seed); }
+		inline glm::dvec3 operator ()(const glm::ivec3& pos) const { return getGradient<double>(pos, seed); }
+	};
+	// looks the gradient of a lattice point up in the permutation table (GradientMode::Permutation)
+	struct PermutedGradients {
+		using Table = NoiseGen::PermutationTable;
+		static constexpr int mask = Table::mask;
+		static_assert((vecPool2d<double>.size() & (vecPool2d<double>.size() - 1)) == 0, "The 2d gradients must be picked with a mask");
+
+		const Table& table;
+
+		inline glm::dvec2 operator ()(const glm::ivec2& pos) const noexcept {
+			const size_t i = table.perm[static_cast<size_t>(table.perm[static_cast<size_t>(pos.x & mask)] + (pos.y & mask))];
+			return vecPool2d<double>[i & (vecPool2d<double>.size() - 1)];
+		}
+		inline glm::dvec3 operator ()(const glm::ivec3& pos) const noexcept {
+			const size_t xy = table.perm[static_cast<size_t>(table.perm[static_cast<size_t>(pos.x & mask)] + (pos.y & mask))];
+			return vecPool3d<double>[table.gradients3d[xy + static_cast<size_t>(pos.z & mask)]];
+		}
+	};
+
+	template<typename T, typename G, std::enable_if_t<std::numeric_limits<T>::is_iec559, int> = 0>
+	static T getOctave(const glm::ivec2& pos, const T frequency, const G& gradients) {
 		using tvec2 = glm::vec<2, T>;
 		using glm::ivec2;
 		const tvec2 s { static_cast<tvec2>(pos) / frequency }; // scaled position
 		const ivec2 p { glm::floor(s) }; // floor(scaled position)
 		const tvec2 f { glm::fract(s) }; // fract(scaled position)
 		const T x1 = glm::mix(
-			(glm::dot(getGradient<T>(p, seed), f) + T{1}) / T{2},
-			(glm::dot(getGradient<T>(p + ivec2(1, 0), seed), f - tvec2(1, 0)) + T{1}) / T{2},
+			(glm::dot(gradients(p), f) + T{1}) / T{2},
+			(glm::dot(gradients(p + ivec2(1, 0)), f - tvec2(1, 0)) + T{1}) / T{2},
 			smoothstep(f.x)
 		);
 		const T x2 = glm::mix(
-			(glm::dot(getGradient<T>(p + ivec2(0, 1), seed), f - tvec2(0, 1)) + T{1}) / T{2},
-			(glm::dot(getGradient<T>(p + ivec2(1, 1), seed), f - tvec2(1, 1)) + T{1}) / T{2},
+			(glm::dot(gradients(p + ivec2(0, 1)), f - tvec2(0, 1)) + T{1}) / T{2},
+			(glm::dot(gradients(p + ivec2(1, 1)), f - tvec2(1, 1)) + T{1}) / T{2},
 			smoothstep(f.x)
 		);
 		return glm::mix(x1, x2, smoothstep(f.y));
 	}
-	template<typename T, std::enable_if_t<std::numeric_limits<T>::is_iec559, int> = 0>
-	static T getOctave(const glm::ivec3& pos, const T frequency, const RNG::seed_t seed) {
+	template<typename T, typename G, std::enable_if_t<std::numeric_limits<T>::is_iec559, int> = 0>
+	static T getOctave(const glm::ivec3& pos, const T frequency, const G& gradients) {
 		using tvec3 = glm::vec<3, T>;
 		using glm::ivec3;
 		const tvec3 s { static_cast<tvec3>(pos) / frequency }; // scaled position
 		const ivec3 p { glm::floor(s) }; // floor(scaled position)
 		const tvec3 f { glm::fract(s) }; // fract(scaled position)
 		const T x1 = glm::mix(
-			(glm::dot(getGradient<T>(p, seed), f) + T{1}) / T{2},
-			(glm::dot(getGradient<T>(p + ivec3(1, 0, 0), seed), f - tvec3(1, 0, 0)) + T{1}) / T{2},
+			(glm::dot(gradients(p), f) + T{1}) / T{2},
+			(glm::dot(gradients(p + ivec3(1, 0, 0)), f - tvec3(1, 0, 0)) + T{1}) / T{2},
 			smoothstep(f.x)
 		);
 		const T x2 = glm::mix(
-			(glm::dot(getGradient<T>(p + ivec3(0, 1, 0), seed), f - tvec3(0, 1, 0)) + T{1}) / T{2},
-			(glm::dot(getGradient<T>(p + ivec3(1, 1, 0), seed), f - tvec3(1, 1, 0)) + T{1}) / T{2},
+			(glm::dot(gradients(p + ivec3(0, 1, 0)), f - tvec3(0, 1, 0)) + T{1}) / T{2},
+			(glm::dot(gradients(p + ivec3(1, 1, 0)), f - tvec3(1, 1, 0)) + T{1}) / T{2},
 			smoothstep(f.x)
 		);
 		const T x3 = glm::mix(
-			(glm::dot(getGradient<T>(p + ivec3(0, 0, 1), seed), f - tvec3(0, 0, 1)) + T{1}) / T{2},
-			(glm::dot(getGradient<T>(p + ivec3(1, 0, 1), seed), f - tvec3(1, 0, 1)) + T{1}) / T{2},
+			(glm::dot(gradients(p + ivec3(0, 0, 1)), f - tvec3(0, 0, 1)) + T{1}) / T{2},
+			(glm::dot(gradients(p + ivec3(1, 0, 1)), f - tvec3(1, 0, 1)) + T{1}) / T{2},
 			smoothstep(f.x)
 		);
 		const T x4 = glm::mix(
-			(glm::dot(getGradient<T>(p + ivec3(0, 1, 1), seed), f - tvec3(0, 1, 1)) + T{1}) / T{2},
-			(glm::dot(getGradient<T>(p + ivec3(1, 1, 1), seed), f - tvec3(1, 1, 1)) + T{1}) / T{2},
+			(glm::dot(gradients(p + ivec3(0, 1, 1)), f - tvec3(0, 1, 1)) + T{1}) / T{2},
+			(glm::dot(gradients(p + ivec3(1, 1, 1)), f - tvec3(1, 1, 1)) + T{1}) / T{2},
 			smoothstep(f.x)
 		);
 		const T y1 = glm::mix(x1, x2, smoothstep(f.y));
@@ -148,28 +195,30 @@ namespace eng {
 		return glm::mix(y1, y2, smoothstep(f.z));
 	}
 
-	double NoiseGen::getNoise(const glm::ivec2& pos, const RNG::seed_t seed, const NoiseParams& params, const glm::ivec2& period) {
+	template<typename G>
+	static double getNoiseImpl(const glm::ivec2& pos, const NoiseGen::NoiseParams& params, const glm::ivec2& period, const G& gradients) {
 		double max = 0;
 		double noise = 0;
 		double freq = params.frequency;
 		double amp = params.amplitude;
 		const glm::ivec2 p = (period != glm::ivec2(0, 0)) ? (((pos % period) + period) % period) : pos;
 		for (int i = 0; i < params.octaves; i++) {
-			noise += getOctave(p, freq, seed) * amp;
+			noise += getOctave(p, freq, gradients) * amp;
 			max += amp;
 			amp *= params.persistence;
 			freq *= 0.5;
 		}
 		return noise / max;
 	}
-	double NoiseGen::getNoise(const glm::ivec3& pos, const RNG::seed_t seed, const NoiseParams& params, const glm::ivec3& period) {
+	template<typename G>
+	static double getNoiseImpl(const glm::ivec3& pos, const NoiseGen::NoiseParams& params, const glm::ivec3& period, const G& gradients) {
 		double max = 0;
 		double noise = 0;
 		double freq = params.frequency;
 		double amp = params.amplitude;
 		const glm::ivec3 p = (period != glm::ivec3(0, 0, 0)) ? (((pos % period) + period) % period) : pos;
 		for (int i = 0; i < params.octaves; i++) {
-			noise += getOctave(p, freq, seed) * amp;
+			noise += getOctave(p, freq, gradients) * amp;
 			max += amp;
 			amp *= params.persistence;
 			freq *= 0.5;
@@ -177,4 +226,247 @@ namespace eng {
 		return noise / max;
 	}
 
-}
\ No newline at end of file
+	double NoiseGen::getNoise(const glm::ivec2& pos, const RNG::seed_t seed, const NoiseParams& params, const glm::ivec2& period) {
+		return getNoiseImpl(pos, params, period, HashedGradients { seed });
+	}
+	double NoiseGen::getNoise(const glm::ivec3& pos, const RNG::seed_t seed, const NoiseParams& params, const glm::ivec3& period) {
+		return getNoiseImpl(pos, params, period, HashedGradients { seed });
+	}
+
+	double NoiseGen::sample(const glm::ivec2& pos, const NoiseParams& params, const glm::ivec2& period) const {
+		if (gradientMode == GradientMode::Hashed) return getNoiseImpl(pos, params, period, HashedGradients { seed });
+		return getNoiseImpl(pos, params, period, PermutedGradients { permutation });
+	}
+	double NoiseGen::sample(const glm::ivec3& pos, const NoiseParams& params, const glm::ivec3& period) const {
+		if (gradientMode == GradientMode::Hashed) return getNoiseImpl(pos, params, period, HashedGradients { seed });
+		return getNoiseImpl(pos, params, period, PermutedGradients { permutation });
+	}
+
+	// the lattice coordinates of the samples along one axis of a batch, for a single octave
+	struct AxisSamples {
+		std::vector<size_t> cells; // floor(scaled position) - minCell
+		std::vector<double> fracts; // fract(scaled position)
+		std::vector<double> smooths; // smoothstep(fract(scaled position))
+		int minCell = 0;
+		size_t cellCount = 0; // number of lattice points that the samples are between
+
+		void compute(const int origin, const int size, const int stride, const int period, const double frequency) {
+			const auto count = static_cast<size_t>(size);
+			std::vector<int> floors(count);
+			fracts.resize(count);
+			smooths.resize(count);
+			for (size_t i = 0; i < count; i++) {
+				const int samplePos = origin + (static_cast<int>(i) * stride);
+				const int pos = (period != 0) ? (((samplePos % period) + period) % period) : samplePos;
+				const double s = static_cast<double>(pos) / frequency;
+				const double p = std::floor(s);
+				floors[i] = static_cast<int>(p);
+				fracts[i] = s - p;
+				smooths[i] = smoothstep(fracts[i]);
+			}
+			const auto [minFloor, maxFloor] = std::minmax_element(floors.begin(), floors.end());
+			minCell = *minFloor;
+			cellCount = static_cast<size_t>(*maxFloor - minCell) + 2;
+			cells.resize(count);
+			for (size_t i = 0; i < count; i++) cells[i] = static_cast<size_t>(floors[i] - minCell);
+		}
+	};
+
+	// a range of samples along the x axis that are in the same lattice cell
+	struct SampleRun {
+		size_t begin, end;
+	};
+	static void findRuns(const AxisSamples& xAxis, std::vector<SampleRun>& runs) {
+		runs.clear();
+		const size_t size = xAxis.cells.size();
+		for (size_t begin = 0; begin < size;) {
+			size_t end = begin + 1;
+			while ((end < size) && (xAxis.cells[end] == xAxis.cells[begin])) end++;
+			runs.push_back({ begin, end });
+			begin = end;
+		}
+	}
+
+	// the contribution of a lattice corner to a sample, (dot(gradient, offset) + 1) / 2, split into the part that depends on the
+	// sample's x offset from the corner and the part that is the same for a whole run of samples
+	struct CornerTerms {
+		double slope; // gradient.x / 2
+		double constant; // (dot(gradient.yz, offset.yz) + 1) / 2
+
+		CornerTerms(const double gradientX, const double dotRest) noexcept :
+				slope(gradientX * 0.5), constant((dotRest + 1.0) * 0.5) {}
+	};
+
+	template<typename B>
+	static inline B lerp(const B a, const B b, const B t) noexcept {
+		return a + ((b - a) * t);
+	}
+	template<typename B>
+	static inline B cornerValue(const B fx, const CornerTerms& corner) noexcept {
+		return (B::broadcast(corner.slope) * fx) + B::broadcast(corner.constant);
+	}
+
+	// adds the octave to out for the samples [begin, end) of a row, where corners are the corners of the lattice cell at
+	// (0, 0), (1, 0), (0, 1), (1, 1) in 2d or (0, 0, 0), (1, 0, 0), (0, 1, 0), (1, 1, 0), (0, 0, 1), (1, 0, 1), (0, 1, 1), (1, 1, 1) in 3d
+	template<typename B, size_t Corners>
+	static inline size_t addOctaveToRun(const AxisSamples& xAxis, size_t i, const size_t end, const std::array<CornerTerms, Corners>& corners,
+			const double smoothY, const double smoothZ, const double amplitude, double* const out) noexcept {
+		for (; (i + B::size) <= end; i += B::size) {
+			const B fx = B::load(xAxis.fracts.data() + i);
+			const B fx1 = fx - B::broadcast(1.0);
+			const B sx = B::load(xAxis.smooths.data() + i);
+			const B x1 = lerp(cornerValue(fx, corners[0]), cornerValue(fx1, corners[1]), sx);
+			const B x2 = lerp(cornerValue(fx, corners[2]), cornerValue(fx1, corners[3]), sx);
+			B value = lerp(x1, x2, B::broadcast(smoothY));
+			if constexpr (Corners == 8) {
+				const B x3 = lerp(cornerValue(fx, corners[4]), cornerValue(fx1, corners[5]), sx);
+				const B x4 = lerp(cornerValue(fx, corners[6]), cornerValue(fx1, corners[7]), sx);
+				value = lerp(value, lerp(x3, x4, B::broadcast(smoothY)), B::broadcast(smoothZ));
+			}
+			(B::load(out + i) + (value * B::broadcast(amplitude))).store(out + i);
+		}
+		return i;
+	}
+	template<size_t Corners>
+	static inline void addOctaveToRun(const AxisSamples& xAxis, const SampleRun& run, const std::array<CornerTerms, Corners>& corners,
+			const double smoothY, const double smoothZ, const double amplitude, double* const out) noexcept {
+		const size_t i = addOctaveToRun<simd::double_batch>(xAxis, run.begin, run.end, corners, smoothY, smoothZ, amplitude, out);
+		addOctaveToRun<simd::double_scalar>(xAxis, i, run.end, corners, smoothY, smoothZ, amplitude, out);
+	}
+
+	// divides each sample by the sum of the octaves' amplitudes
+	static void normalize(const std::span<double> out, const double max) noexcept {
+		const double scale = 1.0 / max;
+		size_t i = 0;
+		for (; (i + simd::double_batch::size) <= out.size(); i += simd::double_batch::size)
+			(simd::double_batch::load(out.data() + i) * simd::double_batch::broadcast(scale)).store(out.data() + i);
+		for (; i < out.size(); i++) out[i] *= scale;
+	}
+
+	template<typename G>
+	static void fillNoiseImpl(const glm::ivec2& origin, const glm::ivec2& size, const glm::ivec2& stride, const std::span<double> out,
+			const NoiseGen::NoiseParams& params, const glm::ivec2& period, const G& gradients) {
+		if ((size.x < 0) || (size.y < 0) || (out.size() < (static_cast<size_t>(size.x) * static_cast<size_t>(size.y))))
+			throw std::invalid_argument("NoiseGen::fillNoise2D output is too small for the box");
+		const size_t sampleCount = static_cast<size_t>(size.x) * static_cast<size_t>(size.y);
+		std::fill_n(out.begin(), sampleCount, 0.0);
+		if (sampleCount == 0) return;
+
+		AxisSamples xAxis, yAxis;
+		std::vector<SampleRun> runs;
+		std::vector<glm::dvec2> latticeGradients;
+		double max = 0;
+		double freq = params.frequency;
+		double amp = params.amplitude;
+		for (int octave = 0; octave < params.octaves; octave++) {
+			xAxis.compute(origin.x, size.x, stride.x, period.x, freq);
+			yAxis.compute(origin.y, size.y, stride.y, period.y, freq);
+			findRuns(xAxis, runs);
+			// the gradients of every lattice point around the box
+			latticeGradients.resize(xAxis.cellCount * yAxis.cellCount);
+			for (size_t y = 0; y < yAxis.cellCount; y++)
+				for (size_t x = 0; x < xAxis.cellCount; x++)
+					latticeGradients[(y * xAxis.cellCount) + x] = gradients(glm::ivec2(xAxis.minCell + static_cast<int>(x), yAxis.minCell + static_cast<int>(y)));
+
+			for (size_t y = 0; y < yAxis.cells.size(); y++) {
+				const size_t cellY = yAxis.cells[y];
+				const double fy = yAxis.fracts[y];
+				double* const row = out.data() + (y * xAxis.cells.size());
+				for (const SampleRun& run : runs) {
+					const glm::dvec2* const g = latticeGradients.data() + (cellY * xAxis.cellCount) + xAxis.cells[run.begin];
+					const glm::dvec2* const gAbove = g + xAxis.cellCount;
+					const std::array<CornerTerms, 4> corners {{
+						{ g[0].x, g[0].y * fy }, { g[1].x, g[1].y * fy },
+						{ gAbove[0].x, gAbove[0].y * (fy - 1.0) }, { gAbove[1].x, gAbove[1].y * (fy - 1.0) },
+					}};
+					addOctaveToRun(xAxis, run, corners, yAxis.smooths[y], 0.0, amp, row);
+				}
+			}
+			max += amp;
+			amp *= params.persistence;
+			freq *= 0.5;
+		}
+		normalize(out.first(sampleCount), max);
+	}
+
+	template<typename G>
+	static void fillNoiseImpl(const glm::ivec3& origin, const glm::ivec3& size, const glm::ivec3& stride, const std::span<double> out,
+			const NoiseGen::NoiseParams& params, const glm::ivec3& period, const G& gradients) {
+		if ((size.x < 0) || (size.y < 0) || (size.z < 0) || (out.size() < (static_cast<size_t>(size.x) * static_cast<size_t>(size.y) * static_cast<size_t>(size.z))))
+			throw std::invalid_argument("NoiseGen::fillNoise3D output is too small for the box");
+		const size_t sampleCount = static_cast<size_t>(size.x) * static_cast<size_t>(size.y) * static_cast<size_t>(size.z);
+		std::fill_n(out.begin(), sampleCount, 0.0);
+		if (sampleCount == 0) return;
+
+		AxisSamples xAxis, yAxis, zAxis;
+		std::vector<SampleRun> runs;
+		std::vector<glm::dvec3> latticeGradients;
+		double max = 0;
+		double freq = params.frequency;
+		double amp = params.amplitude;
+		for (int octave = 0; octave < params.octaves; octave++) {
+			xAxis.compute(origin.x, size.x, stride.x, period.x, freq);
+			yAxis.compute(origin.y, size.y, stride.y, period.y, freq);
+			zAxis.compute(origin.z, size.z, stride.z, period.z, freq);
+			findRuns(xAxis, runs);
+			const size_t layerCells = xAxis.cellCount * yAxis.cellCount;
+			latticeGradients.resize(layerCells * zAxis.cellCount);
+			for (size_t z = 0; z < zAxis.cellCount; z++)
+				for (size_t y = 0; y < yAxis.cellCount; y++)
+					for (size_t x = 0; x < xAxis.cellCount; x++)
+						latticeGradients[(((z * yAxis.cellCount) + y) * xAxis.cellCount) + x] = gradients(glm::ivec3(
+							xAxis.minCell + static_cast<int>(x), yAxis.minCell + static_cast<int>(y), zAxis.minCell + static_cast<int>(z)
+						));
+
+			for (size_t z = 0; z < zAxis.cells.size(); z++) {
+				const double fz = zAxis.fracts[z];
+				for (size_t y = 0; y < yAxis.cells.size(); y++) {
+					const double fy = yAxis.fracts[y];
+					double* const row = out.data() + (((z * yAxis.cells.size()) + y) * xAxis.cells.size());
+					const size_t cellRow = ((zAxis.cells[z] * yAxis.cellCount) + yAxis.cells[y]) * xAxis.cellCount;
+					for (const SampleRun& run : runs) {
+						const glm::dvec3* const g = latticeGradients.data() + cellRow + xAxis.cells[run.begin];
+						const glm::dvec3* const gY = g + xAxis.cellCount;
+						const glm::dvec3* const gZ = g + layerCells;
+						const glm::dvec3* const gYZ = gZ + xAxis.cellCount;
+						const auto terms = [](const glm::dvec3& gradient, const double oy, const double oz) {
+							return CornerTerms { gradient.x, (gradient.y * oy) + (gradient.z * oz) };
+						};
+						const std::array<CornerTerms, 8> corners {
+							terms(g[0], fy, fz), terms(g[1], fy, fz),
+							terms(gY[0], fy - 1.0, fz), terms(gY[1], fy - 1.0, fz),
+							terms(gZ[0], fy, fz - 1.0), terms(gZ[1], fy, fz - 1.0),
+							terms(gYZ[0], fy - 1.0, fz - 1.0), terms(gYZ[1], fy - 1.0, fz - 1.0),
+						};
+						addOctaveToRun(xAxis, run, corners, yAxis.smooths[y], zAxis.smooths[z], amp, row);
+					}
+				}
+			}
+			max += amp;
+			amp *= params.persistence;
+			freq *= 0.5;
+		}
+		normalize(out.first(sampleCount), max);
+	}
+
+	void NoiseGen::fillNoise2D(const glm::ivec2& origin, const glm::ivec2& size, const glm::ivec2& stride, const std::span<double> out,
+			const RNG::seed_t seed, const NoiseParams& params, const glm::ivec2& period) {
+		fillNoiseImpl(origin, size, stride, out, params, period, HashedGradients { seed });
+	}
+	void NoiseGen::fillNoise3D(const glm::ivec3& origin, const glm::ivec3& size, const glm::ivec3& stride, const std::span<double> out,
+			const RNG::seed_t seed, const NoiseParams& params, const glm::ivec3& period) {
+		fillNoiseImpl(origin, size, stride, out, params, period, HashedGradients { seed });
+	}
+
+	void NoiseGen::fill(const glm::ivec2& origin, const glm::ivec2& size, const glm::ivec2& stride, const std::span<double> out,
+			const NoiseParams& params, const glm::ivec2& period) const {
+		if (gradientMode == GradientMode::Hashed) fillNoiseImpl(origin, size, stride, out, params, period, HashedGradients { seed });
+		else fillNoiseImpl(origin, size, stride, out, params, period, PermutedGradients { permutation });
+	}
+	void NoiseGen::fill(const glm::ivec3& origin, const glm::ivec3& size, const glm::ivec3& stride, const std::span<double> out,
+			const NoiseParams& params, const glm::ivec3& period) const {
+		if (gradientMode == GradientMode::Hashed) fillNoiseImpl(origin, size, stride, out, params, period, HashedGradients { seed });
+		else fillNoiseImpl(origin, size, stride, out, params, period, PermutedGradients { permutation });
+	}
+
+}
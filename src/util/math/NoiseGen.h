@@ -1,5 +1,10 @@
 #pragma once
 
+#include <array>
+#include <span>
+#include <cstdint>
+#include <cstddef>
+
 #include <glm/vec2.hpp>
 #include <glm/vec3.hpp>
 
@@ -15,15 +20,41 @@ namespace eng {
 			double persistence { 0.4 };
 			int octaves { 4 };
 		};
+
+		// how the gradient of each lattice point is picked
+		enum class GradientMode : uint8_t {
+			Permutation, // look the gradient up in a permutation table shuffled with the seed
+			// hash the lattice point with the seed, which reproduces the noise values from before the permutation table
+			// this only affects the noise itself: terrain generation has changed since then, so worlds still don't match older versions
+			Hashed,
+		};
+
+		// a random permutation of [0, size), repeated twice so that nested lookups don't have to wrap the sum of an entry and a coordinate
+		// the noise repeats every size lattice points
+		struct PermutationTable {
+			static constexpr size_t size = 1024;
+			static constexpr int mask = static_cast<int>(size - 1);
+
+			std::array<uint16_t, size * 2> perm {};
+			std::array<uint8_t, size * 2> gradients3d {}; // perm[i] % the number of 3d gradients
+
+			PermutationTable() = default;
+			explicit PermutationTable(RNG::seed_t seed);
+		};
+
 	private:
 		NoiseParams defaultParams;
 		glm::ivec2 period2d { 0, 0 };
 		glm::ivec3 period3d { 0, 0, 0 };
 		
 		RNG::seed_t seed;
+		GradientMode gradientMode;
+		PermutationTable permutation; // only filled in with GradientMode::Permutation
 
 	public:
-		[[nodiscard]] NoiseGen(RNG::seed_t seed, const NoiseParams& params) noexcept;
+		[[nodiscard]] NoiseGen(RNG::seed_t seed, const NoiseParams& params, GradientMode gradientMode = GradientMode::Permutation) noexcept;
+
+		inline GradientMode getGradientMode() const noexcept { return gradientMode; }
 
 		NoiseGen& setPeriod2D(const glm::ivec2& period) noexcept {
 			period2d = period;
@@ -35,21 +66,51 @@ namespace eng {
 		}
 
 		[[nodiscard]] inline double getNoise(const glm::ivec2& pos, double freq, double amp, double persist) const {
-			return getNoise(pos, seed, { freq, amp, persist, defaultParams.octaves }, period2d);
+			return sample(pos, { freq, amp, persist, defaultParams.octaves }, period2d);
 		}
 		[[nodiscard]] inline double getNoise(const glm::ivec2& pos) const {
-			return getNoise(pos, seed, defaultParams, period2d);
+			return sample(pos, defaultParams, period2d);
 		}
 		[[nodiscard]] inline double getNoise(const glm::ivec3& pos, double freq, double amp, double persist) const {
-			return getNoise(pos, seed, { freq, amp, persist, defaultParams.octaves }, period3d);
+			return sample(pos, { freq, amp, persist, defaultParams.octaves }, period3d);
 		}
 		[[nodiscard]] inline double getNoise(const glm::ivec3& pos) const {
-			return getNoise(pos, seed, defaultParams, period3d);
+			return sample(pos, defaultParams, period3d);
 		}
 
+		// the static versions of getNoise and fillNoise always use GradientMode::Hashed, since they don't have a permutation table
 		[[nodiscard]] static double getNoise(const glm::ivec2& pos, RNG::seed_t seed, const NoiseParams& params, const glm::ivec2& period = { 0, 0 });
 		[[nodiscard]] static double getNoise(const glm::ivec3& pos, RNG::seed_t seed, const NoiseParams& params, const glm::ivec3& period = { 0, 0, 0 });
 
+		// batch versions of getNoise, which fill out with the noise at the positions origin + (i * stride) for every i in the box [0, size)
+		// out is indexed with x varying fastest, then y, then z (out[(z * size.x) + x] in 2d, out[(((z * size.y) + y) * size.x) + x] in 3d)
+		// each lattice gradient is only computed once per octave, and the samples are interpolated in SIMD batches,
+		// so filling a box is much faster than calling getNoise for each position (the results match getNoise up to rounding)
+		inline void fillNoise2D(const glm::ivec2& origin, const glm::ivec2& size, std::span<double> out) const {
+			fill(origin, size, { 1, 1 }, out, defaultParams, period2d);
+		}
+		inline void fillNoise2D(const glm::ivec2& origin, const glm::ivec2& size, const glm::ivec2& stride, std::span<double> out) const {
+			fill(origin, size, stride, out, defaultParams, period2d);
+		}
+		inline void fillNoise3D(const glm::ivec3& origin, const glm::ivec3& size, std::span<double> out) const {
+			fill(origin, size, { 1, 1, 1 }, out, defaultParams, period3d);
+		}
+		inline void fillNoise3D(const glm::ivec3& origin, const glm::ivec3& size, const glm::ivec3& stride, std::span<double> out) const {
+			fill(origin, size, stride, out, defaultParams, period3d);
+		}
+
+		static void fillNoise2D(const glm::ivec2& origin, const glm::ivec2& size, const glm::ivec2& stride, std::span<double> out,
+				RNG::seed_t seed, const NoiseParams& params, const glm::ivec2& period = { 0, 0 });
+		static void fillNoise3D(const glm::ivec3& origin, const glm::ivec3& size, const glm::ivec3& stride, std::span<double> out,
+				RNG::seed_t seed, const NoiseParams& params, const glm::ivec3& period = { 0, 0, 0 });
+
+	private:
+		// use the generator's gradient mode
+		double sample(const glm::ivec2& pos, const NoiseParams& params, const glm::ivec2& period) const;
+		double sample(const glm::ivec3& pos, const NoiseParams& params, const glm::ivec3& period) const;
+		void fill(const glm::ivec2& origin, const glm::ivec2& size, const glm::ivec2& stride, std::span<double> out, const NoiseParams& params, const glm::ivec2& period) const;
+		void fill(const glm::ivec3& origin, const glm::ivec3& size, const glm::ivec3& stride, std::span<double> out, const NoiseParams& params, const glm::ivec3& period) const;
+
 	};
 	
 }
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#if defined(ENG_SIMD_AVX2)
+#include <immintrin.h>
+#elif defined(ENG_SIMD_SSE4)
+#include <smmintrin.h>
+#endif
+
+/*
+ * Minimal batches of doubles and of 32-bit unsigned integers, for loops that run the same arithmetic over contiguous arrays.
+ * The batch width is picked at compile time from the instruction set that CMake's SIMD_LEVEL enables (ENG_SIMD_AVX2 or ENG_SIMD_SSE4):
+ * 4 doubles or 8 integers with AVX2, 2 doubles or 4 integers with SSE4.1, and a single lane otherwise.
+ * double_scalar and uint32_scalar have the same interface with a single lane, for the elements left over at the end of an array.
+ * Integer arithmetic wraps around, and gives the same results in every lane width.
+ */
+
+namespace eng::simd {
+
+	struct double_scalar {
+		static constexpr size_t size = 1;
+		double v;
+
+		static inline double_scalar load(const double* const p) noexcept { return { *p }; }
+		static inline double_scalar broadcast(const double d) noexcept { return { d }; }
+		inline void store(double* const p) const noexcept { *p = v; }
+
+		friend inline double_scalar operator +(const double_scalar a, const double_scalar b) noexcept { return { a.v + b.v }; }
+		friend inline double_scalar operator -(const double_scalar a, const double_scalar b) noexcept { return { a.v - b.v }; }
+		friend inline double_scalar operator *(const double_scalar a, const double_scalar b) noexcept { return { a.v * b.v }; }
+	};
+
+	struct uint32_scalar {
+		static constexpr size_t size = 1;
+		uint32_t v;
+
+		static inline uint32_scalar broadcast(const uint32_t i) noexcept { return { i }; }
+		// first, first + 1, ... in successive lanes
+		static inline uint32_scalar sequence(const uint32_t first) noexcept { return { first }; }
+		inline void store(uint32_t* const p) const noexcept { *p = v; }
+		// stores each lane converted to a float and multiplied by scale, where every lane has to be below 2^31
+		inline void storeFloat(float* const p, const float scale) const noexcept { *p = static_cast<float>(static_cast<int32_t>(v)) * scale; }
+
+		friend inline uint32_scalar operator +(const uint32_scalar a, const uint32_scalar b) noexcept { return { a.v + b.v }; }
+		friend inline uint32_scalar operator *(const uint32_scalar a, const uint32_scalar b) noexcept { return { a.v * b.v }; }
+		friend inline uint32_scalar operator ^(const uint32_scalar a, const uint32_scalar b) noexcept { return { a.v ^ b.v }; }
+		friend inline uint32_scalar operator >>(const uint32_scalar a, const int shift) noexcept { return { a.v >> shift }; }
+	};
+
+#if defined(ENG_SIMD_AVX2)
+
+	struct double_batch {
+		static constexpr size_t size = 4;
+		__m256d v;
+
+		static inline double_batch load(const double* const p) noexcept { return { _mm256_loadu_pd(p) }; }
+		static inline double_batch broadcast(const double d) noexcept { return { _mm256_set1_pd(d) }; }
+		inline void store(double* const p) const noexcept { _mm256_storeu_pd(p, v); }
+
+		friend inline double_batch operator +(const double_batch a, const double_batch b) noexcept { return { _mm256_add_pd(a.v, b.v) }; }
+		friend inline double_batch operator -(const double_batch a, const double_batch b) noexcept { return { _mm256_sub_pd(a.v, b.v) }; }
+		friend inline double_batch operator *(const double_batch a, const double_batch b) noexcept { return { _mm256_mul_pd(a.v, b.v) }; }
+	};
+
+	struct uint32_batch {
+		static constexpr size_t size = 8;
+		__m256i v;
+
+		static inline uint32_batch broadcast(const uint32_t i) noexcept { return { _mm256_set1_epi32(static_cast<int>(i)) }; }
+		static inline uint32_batch sequence(const uint32_t first) noexcept {
+			return { _mm256_add_epi32(_mm256_set1_epi32(static_cast<int>(first)), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7)) };
+		}
+		inline void store(uint32_t* const p) const noexcept { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v); }
+		inline void storeFloat(float* const p, const float scale) const noexcept { _mm256_storeu_ps(p, _mm256_mul_ps(_mm256_cvtepi32_ps(v), _mm256_set1_ps(scale))); }
+
+		friend inline uint32_batch operator +(const uint32_batch a, const uint32_batch b) noexcept { return { _mm256_add_epi32(a.v, b.v) }; }
+		friend inline uint32_batch operator *(const uint32_batch a, const uint32_batch b) noexcept { return { _mm256_mullo_epi32(a.v, b.v) }; }
+		friend inline uint32_batch operator ^(const uint32_batch a, const uint32_batch b) noexcept { return { _mm256_xor_si256(a.v, b.v) }; }
+		friend inline uint32_batch operator >>(const uint32_batch a, const int shift) noexcept { return { _mm256_srl_epi32(a.v, _mm_cvtsi32_si128(shift)) }; }
+	};
+
+#elif defined(ENG_SIMD_SSE4)
+
+	struct double_batch {
+		static constexpr size_t size = 2;
+		__m128d v;
+
+		static inline double_batch load(const double* const p) noexcept { return { _mm_loadu_pd(p) }; }
+		static inline double_batch broadcast(const double d) noexcept { return { _mm_set1_pd(d) }; }
+		inline void store(double* const p) const noexcept { _mm_storeu_pd(p, v); }
+
+		friend inline double_batch operator +(const double_batch a, const double_batch b) noexcept { return { _mm_add_pd(a.v, b.v) }; }
+		friend inline double_batch operator -(const double_batch a, const double_batch b) noexcept { return { _mm_sub_pd(a.v, b.v) }; }
+		friend inline double_batch operator *(const double_batch a, const double_batch b) noexcept { return { _mm_mul_pd(a.v, b.v) }; }
+	};
+
+	struct uint32_batch {
+		static constexpr size_t size = 4;
+		__m128i v;
+
+		static inline uint32_batch broadcast(const uint32_t i) noexcept { return { _mm_set1_epi32(static_cast<int>(i)) }; }
+		static inline uint32_batch sequence(const uint32_t first) noexcept {
+			return { _mm_add_epi32(_mm_set1_epi32(static_cast<int>(first)), _mm_setr_epi32(0, 1, 2, 3)) };
+		}
+		inline void store(uint32_t* const p) const noexcept { _mm_storeu_si128(reinterpret_cast<__m128i*>(p), v); }
+		inline void storeFloat(float* const p, const float scale) const noexcept { _mm_storeu_ps(p, _mm_mul_ps(_mm_cvtepi32_ps(v), _mm_set1_ps(scale))); }
+
+		friend inline uint32_batch operator +(const uint32_batch a, const uint32_batch b) noexcept { return { _mm_add_epi32(a.v, b.v) }; }
+		friend inline uint32_batch operator *(const uint32_batch a, const uint32_batch b) noexcept { return { _mm_mullo_epi32(a.v, b.v) }; }
+		friend inline uint32_batch operator ^(const uint32_batch a, const uint32_batch b) noexcept { return { _mm_xor_si128(a.v, b.v) }; }
+		friend inline uint32_batch operator >>(const uint32_batch a, const int shift) noexcept { return { _mm_srl_epi32(a.v, _mm_cvtsi32_si128(shift)) }; }
+	};
+
+#else
+
+	using double_batch = double_scalar;
+	using uint32_batch = uint32_scalar;
+
+#endif
+
+}
@@ -1,6 +1,12 @@
 #include "World.h"
 
 #include <unordered_set>
+#include <vector>
+#include <algorithm>
+#include <utility>
+#include <string>
+#include <chrono>
+#include <cmath>
 
 #include <glm/geometric.hpp>
 #include <glm/gtx/norm.hpp>
@@ -10,6 +16,7 @@
 #include "util/math/math.h"
 #include "block/BlockRegistry.h"
 #include "fluid/FluidRegistry.h"
+#include "WorldRegionView.h"
 #include "render/world/WorldRenderer.h"
 #include "render/world/chunk/ChunkBakery.h"
 
@@ -18,73 +25,172 @@
 namespace eng {
 
 	static constexpr size_t max_fluid_updates = 512; // TODO: tune value
+	static constexpr size_t unload_sweep_size = 64; // number of loaded chunks checked for unloading by the round-robin sweep each tick
+	static constexpr size_t load_candidate_window = 4; // number of load candidates collected for each chunk that can be loaded or generated
+	static constexpr size_t compression_sweep_size = 64; // number of loaded chunks checked for compression each tick
 
-	// TODO: dynamically determine number of chunks to load each tick
-	size_t World::maxChunkLoads { 3 }; // maximum number of chunks to load per tick
+	static constexpr int lengthSquared(const glm::ivec3& v) noexcept {
+		return (v.x * v.x) + (v.y * v.y) + (v.z * v.z);
+	}
+
+	// returns the index of the first offset in load_candidate_offsets that's at least dist chunks from the player's chunk
+	static size_t getFirstLoadCandidateIndex(const std::vector<glm::ivec3>& offsets, const float dist) {
+		if (dist <= 0.0f) return 0;
+		return static_cast<size_t>(std::partition_point(offsets.begin(), offsets.end(), [dist](const glm::ivec3& offset) {
+			return static_cast<float>(lengthSquared(offset)) < (dist * dist);
+		}) - offsets.begin());
+	}
+
+	// the number of chunk columns that generation can read the terrain heights of: the columns in the loading radius of the player's predicted
+	// position (at most a chunk from the player's), and the neighbors that the chunks in them depend on
+	static size_t getTerrainHeightCacheCapacity() noexcept {
+		const auto columnsAcross = static_cast<size_t>((2 * (World::getChunkLoadingRadius() + 1 + generation_stage::max_neighbor_radius)) + 1);
+		return columnsAcross * columnsAcross;
+	}
 
 
-	World::World(RNG::seed_t seed) :
+	World::World(RNG::seed_t seed) : World(seed, getDefaultSaveDirectory(seed)) {}
+	World::World(RNG::seed_t seed, std::filesystem::path saveDirectory, const NoiseGen::GradientMode gradientMode) :
+			chunkStorage(std::move(saveDirectory)),
 			seed(seed),
-			//terrainGenNoise(seed, { 53.0, 1.0, 0.8, 3 }) {
-			terrainGenNoise(seed, { 123.0, 1.0, 0.6, 4 }) {
+			terrainGenerator(seed, getTerrainHeightCacheCapacity(), gradientMode),
+			chunkGenerator(terrainGenerator) {
 		const auto loadingAreaDim = static_cast<size_t>(std::ceil((unloading_dist * 2.0f) / Chunk::WIDTH));
-		loadedChunks.reserve(loadingAreaDim * loadingAreaDim * loadingAreaDim);
+		loadedChunks.setRadius(getChunkUnloadingRadius());
+		chunkPool.reserve(loadingAreaDim * loadingAreaDim * loadingAreaDim);
 	}
 
-	void World::update() {
-		const ChunkCoord playerChunkCoord = ChunkCoord::fromBlockPos(static_cast<glm::ivec3>(player->getPosition()));
+	World::~World() {
+		for (auto& [chunkCoord, chunk] : loadedChunks) {
+			if (chunk->isModified()) {
+				if (chunk->isCompressed()) chunkStorage.saveChunk(chunkCoord, std::move(chunk->compressedContents));
+				else chunkStorage.saveChunk(*chunk);
+			}
+			chunkPool.destroy(chunk);
+		}
+		loadedChunks.clear();
+		chunkColumns.clear();
+	}
 
-		std::vector<ChunkCoord> toLoad {};
+	std::filesystem::path World::getDefaultSaveDirectory(const RNG::seed_t seed) {
+		return std::filesystem::path("saves") / std::to_string(seed) / "region";
+	}
+
+	void World::update() {
+		const auto tickStartTime = std::chrono::steady_clock::now();
+		loadedChunks.setRadius(getChunkUnloadingRadius()); // in case the load radius was changed
+		terrainGenerator.setHeightCacheCapacity(getTerrainHeightCacheCapacity());
+		const ChunkCoord prevPlayerChunkCoord = playerChunkCoord;
+		playerChunkCoord = ChunkCoord::fromBlockPos(static_cast<glm::ivec3>(player->getPosition()));
+		// the player moved further than walking would take them in a tick (e.g. teleported)
+		const glm::ivec3 playerChunkOffset = glm::abs(static_cast<glm::ivec3>(playerChunkCoord) - static_cast<glm::ivec3>(prevPlayerChunkCoord));
+		const bool playerJumped = vmax(playerChunkOffset.x, playerChunkOffset.y, playerChunkOffset.z) > 1;
+		if ((ticks > 0) && playerJumped)
+			chunkLoadBudget.startRampUp();
+		// limiting the prediction to a chunk keeps prefetched chunks within the unloading radius
+		loadPrioritizer.update(player->getPosition(), player->getPosition() - player->getPrevPosition(), player->getLookVec(), static_cast<float>(Chunk::WIDTH));
+		const ChunkCoord prevPredictedChunkCoord = predictedChunkCoord;
+		predictedChunkCoord = ChunkCoord::fromBlockPos(static_cast<glm::ivec3>(loadPrioritizer.getPredictedPosition()));
+		updateLoadCursor(prevPlayerChunkCoord, prevPredictedChunkCoord, playerJumped);
+
+		std::vector<ChunkCoord> toLoad {}; // saved chunks to load this tick
 		std::vector<ChunkCoord> toUnload {};
 
-		constexpr size_t meshingQueueLimit = 8;
+		// chunks are generated on the chunk generator's threads, so generation can be requested every tick,
+		// but the number of chunks added to the world each tick is limited by the meshing queue
+		// the proto chunks that could still be loaded are kept, including the ones generated only as neighbors of other chunks,
+		// so that enqueueing them later continues from the stages they completed
+		chunkGenerator.cancelQueued([this](const ChunkCoord& chunkCoord) { return shouldUnloadChunk(chunkCoord) && !canLoadChunk(chunkCoord); });
+
 		const size_t meshingQueueSize = (worldRenderer) ? worldRenderer->getChunkBakery().queuedTasks() : 0;
-		if ((meshingQueueSize < meshingQueueLimit)/* && ((ticks % 1) == 0)*/) {
-			const auto loadLimit = std::min(meshingQueueLimit - meshingQueueSize, maxChunkLoads);
-			const int chunkLoadRadius = (static_cast<size_t>(loading_dist) / Chunk::WIDTH);
-			for (int lr = 0; lr <= chunkLoadRadius; lr++) {
-				for (int cz = -lr; cz <= lr; cz++) {
-					for (int cx = (cz == lr || cz == -lr) ? 0 : lr; glm::abs(cx) <= lr; cx = -cx + static_cast<int>(cx <= 0)) {
-						for (int cy = 0; glm::abs(cy) <= chunkLoadRadius; cy = -cy + static_cast<int>(cy <= 0)) {
-							const ChunkCoord chunkCoord { playerChunkCoord.x + cx, playerChunkCoord.y + cy, playerChunkCoord.z + cz };
-							if (!isChunkLoaded(chunkCoord) && canLoadChunk(chunkCoord)) {
-								toLoad.push_back(chunkCoord);
-								if (toLoad.size() >= loadLimit)
-									goto endloadloop;
-							}
-						}
-					}
+		const size_t loadLimit = chunkLoadBudget.getLoadLimit(meshingQueueSize);
+		std::vector<ChunkGenerator::Result> generated = chunkGenerator.takeCompleted(loadLimit);
+		const size_t generationQueueCapacity = chunkGenerator.getQueueCapacity();
+		size_t generationQueueSize = chunkGenerator.queuedTasks();
+
+		// collect the missing chunks after the load cursor, a few times more than can be loaded or generated this tick so that the prioritizer has
+		// some to choose from
+		loadCandidates.clear();
+		const size_t wantedChunks = (loadLimit - std::min(loadLimit, generated.size())) + (generationQueueCapacity - std::min(generationQueueCapacity, generationQueueSize));
+		if (wantedChunks > 0) {
+			const size_t maxCandidates = wantedChunks * load_candidate_window;
+			bool atCursor = true; // whether every chunk checked so far is loaded or out of range
+			for (size_t i = loadCursor; i < load_candidate_offsets.size(); i++) {
+				const ChunkCoord chunkCoord { playerChunkCoord + load_candidate_offsets[i] };
+				if (isChunkLoaded(chunkCoord) || !canLoadChunk(chunkCoord)) {
+					if (atCursor) loadCursor = i + 1;
+					continue;
 				}
+				atCursor = false;
+				if (!chunkGenerator.isGenerating(chunkCoord)) {
+					loadCandidates.push_back(chunkCoord);
+					if (loadCandidates.size() >= maxCandidates) break;
+				}
+			}
+		}
+		loadPrioritizer.sortCandidates(loadCandidates);
+		for (const ChunkCoord& chunkCoord : loadCandidates) {
+			if (chunkStorage.hasChunk(chunkCoord)) {
+				if ((toLoad.size() + generated.size()) < loadLimit) toLoad.push_back(chunkCoord);
+			} else if ((generationQueueSize < generationQueueCapacity) && chunkGenerator.enqueue(chunkCoord)) {
+				generationQueueSize++;
 			}
-		endloadloop:
-			;
+			if (((toLoad.size() + generated.size()) >= loadLimit) && (generationQueueSize >= generationQueueCapacity))
+				break;
+		}
+		const bool allChunksLoaded = (loadCursor >= load_candidate_offsets.size()) && generated.empty() && (generationQueueSize == 0);
+		if (allChunksLoaded) chunkLoadBudget.stopRampUp();
+
+		ChunkLoadBudget::Limit loadLimitedBy = ChunkLoadBudget::Limit::None;
+		if ((toLoad.size() + generated.size()) >= loadLimit) {
+			loadLimitedBy = (loadLimit < chunkLoadBudget.getLoadBudget()) ? ChunkLoadBudget::Limit::MeshingQueue : ChunkLoadBudget::Limit::Budget;
 		}
 
 		doFluidUpdates();
 
 		doBlockUpdates();
 
-		for (auto it = loadedChunks.begin(); it != loadedChunks.end(); it++) {
-			const auto& [chunkCoord, chunk] = *it;
-
-			// unload the chunk if it's out of range
-			if (shouldUnloadChunk(chunkCoord)) {
-				toUnload.push_back(chunkCoord);
-				continue;
+		// unload the chunks that went out of range
+		if (playerJumped || (unloadCheckRadius != unloading_chunk_radius)) {
+			// check every loaded chunk
+			for (const auto& [chunkCoord, chunk] : loadedChunks) {
+				if (shouldUnloadChunk(chunkCoord)) toUnload.push_back(chunkCoord);
+			}
+			unloadCheckRadius = unloading_chunk_radius;
+		} else if (playerChunkCoord != prevPlayerChunkCoord) {
+			// only the chunks on the edge of the previous unloading radius can be out of range
+			for (const glm::ivec3& offset : unloading_shell_offsets) {
+				const ChunkCoord chunkCoord { prevPlayerChunkCoord + offset };
+				if (shouldUnloadChunk(chunkCoord) && isChunkLoaded(chunkCoord)) toUnload.push_back(chunkCoord);
 			}
+		}
+		// check a few chunks each tick, in case a chunk was added out of range
+		for (size_t i = 0, sweepSize = std::min(unload_sweep_size, loadedChunks.size()); i < sweepSize; i++) {
+			if (unloadSweepCursor >= loadedChunks.size()) unloadSweepCursor = 0;
+			const ChunkCoord& chunkCoord = (loadedChunks.begin() + unloadSweepCursor++)->first;
+			if (shouldUnloadChunk(chunkCoord)) toUnload.push_back(chunkCoord);
+		}
 
-			// TODO: handle chunk updates
+		// TODO: handle chunk updates
 
-			// TODO: random block ticks
-		}
+		// TODO: random block ticks
 
 		// TODO: tick entities
 
 		// TODO: tick tile entities
 
-		// load the chunks that were scheduled for loading
-		for (const auto& chunkCoord : toLoad)
-			loadChunk(chunkCoord);
+		// load the saved chunks that were scheduled for loading
+		for (const auto& chunkCoord : toLoad) {
+			if (auto contents = chunkStorage.loadChunk(chunkCoord); contents)
+				loadChunk(chunkCoord, std::move(*contents));
+			else // the saved data couldn't be read
+				chunkGenerator.enqueue(chunkCoord);
+		}
+		// add the chunks that finished generating, unless they went out of range while they were generating
+		for (auto& [chunkCoord, contents] : generated) {
+			if (!shouldUnloadChunk(chunkCoord))
+				loadChunk(chunkCoord, std::move(contents));
+		}
 
 		// unload chunks that were scheduled for unloading
 		for (const auto& chunkCoord : toUnload)
@@ -95,17 +201,21 @@ namespace eng {
 			ChunkBakery& chunkBakery = worldRenderer->getChunkBakery();
 			for (const auto& [chunkCoord, meshingPriority] : dirtyChunks) {
 				if (auto chunk = getChunk(chunkCoord); chunk)
-					chunkBakery.enqueueTask(*chunk, meshingPriority.priority, meshingPriority.fluidOnly);
+					chunkBakery.enqueueTask(*chunk, meshingPriority.priority, meshingPriority.fluidOnly, meshingPriority.regions);
 			}
 		}
 		dirtyChunks.clear();
 
+		compressIdleChunks();
+
+		chunkLoadBudget.reportTick(std::chrono::steady_clock::now() - tickStartTime, meshingQueueSize, loadLimitedBy);
+
 		ticks++;
 	}
 
 
 
-	const BlockState& World::getBlockState(const glm::ivec3& blockPos) const {
+	BlockState World::getBlockState(const glm::ivec3& blockPos) const {
 		if (const Chunk* const chunk = getChunk(ChunkCoord::fromBlockPos(blockPos)); chunk) {
 			return chunk->getBlockState(blockPos);
 		}
@@ -119,7 +229,7 @@ namespace eng {
 		return false;
 	}
 
-	FluidStateRef World::getFluidState(const glm::ivec3& blockPos) const {
+	FluidState World::getFluidState(const glm::ivec3& blockPos) const {
 		if (const Chunk* const chunk = getChunk(ChunkCoord::fromBlockPos(blockPos)); chunk) {
 			return chunk->getFluidState(blockPos);
 		}
@@ -133,24 +243,186 @@ namespace eng {
 		return false;
 	}
 
+	bool World::fillBox(const glm::ivec3& minPos, const glm::ivec3& maxPos, BlockStateRef blockState, const bool updateNeighbors, const MeshingPriority meshingPriority) {
+		const glm::ivec3 boxMin = vec_min(minPos, maxPos);
+		const glm::ivec3 boxMax = vec_max(minPos, maxPos);
+		const ChunkCoord minChunk = ChunkCoord::fromBlockPos(boxMin);
+		const ChunkCoord maxChunk = ChunkCoord::fromBlockPos(boxMax);
+		WorldRegionView region(*this, boxMin);
+		bool changed = false;
+		for (int cz = minChunk.z; cz <= maxChunk.z; cz++) {
+			for (int cy = minChunk.y; cy <= maxChunk.y; cy++) {
+				for (int cx = minChunk.x; cx <= maxChunk.x; cx++) {
+					const ChunkCoord chunkCoord { cx, cy, cz };
+					Chunk* const chunk = getChunk(chunkCoord);
+					if (!chunk) continue;
+					const glm::ivec3& chunkPos = chunk->getBlockPos();
+					const glm::ivec3 cMin = vec_max(boxMin, chunkPos) - chunkPos;
+					const glm::ivec3 cMax = vec_min(boxMax, chunkPos + static_cast<int>(Chunk::WIDTH - 1)) - chunkPos;
+					if (!chunk->fillBlocks(cMin, cMax, blockState)) continue;
+					changed = true;
+					scheduleRemeshAround(chunkPos + cMin, chunkPos + cMax, meshingPriority);
+					// the filled blocks that contain fluids need fluid updates
+					if (chunk->getSummary().hasFluids()) {
+						for (int z = cMin.z; z <= cMax.z; z++)
+							for (int y = cMin.y; y <= cMax.y; y++)
+								for (int x = cMin.x; x <= cMax.x; x++)
+									if (!chunk->getLocalFluidState({ x, y, z }).isEmpty())
+										scheduleFluidUpdate(chunkPos + glm::ivec3(x, y, z), Direction::UNDEFINED);
+					}
+				}
+			}
+		}
+		if (changed && updateNeighbors) { // update the blocks on the outside of each face of the box
+			for (const Direction dir : direction::directions) {
+				const Axis axis = direction::getAxis(dir);
+				const auto axisIndex = getIndex(axis);
+				glm::ivec3 faceMin = boxMin, faceMax = boxMax;
+				if (direction::getAxisDirection(dir) == AxisDirection::POSITIVE)
+					faceMin[axisIndex] = faceMax[axisIndex] = boxMax[axisIndex] + 1;
+				else
+					faceMin[axisIndex] = faceMax[axisIndex] = boxMin[axisIndex] - 1;
+				const Direction srcDir = direction::getOpposite(dir);
+				for (int z = faceMin.z; z <= faceMax.z; z++) {
+					for (int y = faceMin.y; y <= faceMax.y; y++) {
+						for (int x = faceMin.x; x <= faceMax.x; x++) {
+							const glm::ivec3 pos { x, y, z };
+							region.recenter(pos);
+							if (!region.isBlockLoaded(pos)) continue;
+							scheduleBlockUpdate(pos, srcDir);
+							if (!region.getFluidState(pos).isEmpty()) scheduleFluidUpdate(pos, srcDir);
+						}
+					}
+				}
+			}
+		}
+		return changed;
+	}
+
+	bool World::replaceInBox(const glm::ivec3& minPos, const glm::ivec3& maxPos, BlockStateRef target, BlockStateRef replacement, const bool updateNeighbors, const MeshingPriority meshingPriority) {
+		const glm::ivec3 boxMin = vec_min(minPos, maxPos);
+		const glm::ivec3 boxMax = vec_max(minPos, maxPos);
+		const ChunkCoord minChunk = ChunkCoord::fromBlockPos(boxMin);
+		const ChunkCoord maxChunk = ChunkCoord::fromBlockPos(boxMax);
+		std::vector<glm::ivec3> replacedPositions;
+		for (int cz = minChunk.z; cz <= maxChunk.z; cz++) {
+			for (int cy = minChunk.y; cy <= maxChunk.y; cy++) {
+				for (int cx = minChunk.x; cx <= maxChunk.x; cx++) {
+					const ChunkCoord chunkCoord { cx, cy, cz };
+					Chunk* const chunk = getChunk(chunkCoord);
+					if (!chunk) continue;
+					const glm::ivec3& chunkPos = chunk->getBlockPos();
+					const glm::ivec3 cMin = vec_max(boxMin, chunkPos) - chunkPos;
+					const glm::ivec3 cMax = vec_min(boxMax, chunkPos + static_cast<int>(Chunk::WIDTH - 1)) - chunkPos;
+					if (chunk->replaceBlocks(cMin, cMax, target, replacement, replacedPositions))
+						scheduleRemeshAround(chunkPos + cMin, chunkPos + cMax, meshingPriority);
+				}
+			}
+		}
+		if (replacedPositions.empty()) return false;
+		WorldRegionView region(*this, replacedPositions.front());
+		for (const glm::ivec3& pos : replacedPositions) {
+			region.recenter(pos);
+			if (!region.getFluidState(pos).isEmpty()) scheduleFluidUpdate(pos, Direction::UNDEFINED);
+			if (updateNeighbors) {
+				// a neighbor inside the box that now contains the replacement was either replaced too, or was already the same blockstate
+				scheduleEditNeighborUpdates(region, pos, [&](const glm::ivec3& nPos) -> bool {
+					return (nPos.x >= boxMin.x) && (nPos.y >= boxMin.y) && (nPos.z >= boxMin.z) &&
+						(nPos.x <= boxMax.x) && (nPos.y <= boxMax.y) && (nPos.z <= boxMax.z) &&
+						(region.getBlockState(nPos) == replacement);
+				});
+			}
+		}
+		return true;
+	}
+
+	bool World::setBlocks(const std::span<const std::pair<glm::ivec3, BlockState>> blocks, const bool updateNeighbors, const MeshingPriority meshingPriority) {
+		if (blocks.empty()) return false;
+		// group the edits by chunk, keeping the original order of edits to the same position
+		std::vector<size_t> order(blocks.size());
+		for (size_t i = 0; i < order.size(); i++) order[i] = i;
+		std::stable_sort(order.begin(), order.end(), [&blocks](const size_t a, const size_t b) -> bool {
+			const ChunkCoord ca = ChunkCoord::fromBlockPos(blocks[a].first);
+			const ChunkCoord cb = ChunkCoord::fromBlockPos(blocks[b].first);
+			if (ca.x != cb.x) return ca.x < cb.x;
+			if (ca.y != cb.y) return ca.y < cb.y;
+			return ca.z < cb.z;
+		});
+
+		std::unordered_set<glm::ivec3> editedPositions;
+		editedPositions.reserve(blocks.size());
+		std::vector<glm::ivec3> changedPositions;
+		for (size_t begin = 0; begin < order.size();) {
+			const ChunkCoord chunkCoord = ChunkCoord::fromBlockPos(blocks[order[begin]].first);
+			size_t end = begin + 1;
+			while ((end < order.size()) && (ChunkCoord::fromBlockPos(blocks[order[end]].first) == chunkCoord)) end++;
+			if (Chunk* const chunk = getChunk(chunkCoord); chunk) {
+				glm::ivec3 cMin { Chunk::WIDTH, Chunk::WIDTH, Chunk::WIDTH };
+				glm::ivec3 cMax { -1, -1, -1 };
+				for (size_t i = begin; i < end; i++) {
+					const auto& [pos, blockState] = blocks[order[i]];
+					editedPositions.insert(pos);
+					const glm::ivec3 cPos = chunkCoord.getRelativeBlockPos(pos);
+					if (chunk->setLocalBlockState(cPos, blockState)) {
+						changedPositions.push_back(pos);
+						cMin = vec_min(cMin, cPos);
+						cMax = vec_max(cMax, cPos);
+					}
+				}
+				if (cMax.x >= 0) scheduleRemeshAround(chunk->getBlockPos() + cMin, chunk->getBlockPos() + cMax, meshingPriority);
+			}
+			begin = end;
+		}
+		if (changedPositions.empty()) return false;
+
+		WorldRegionView region(*this, changedPositions.front());
+		for (const glm::ivec3& pos : changedPositions) {
+			region.recenter(pos);
+			if (!region.getFluidState(pos).isEmpty()) scheduleFluidUpdate(pos, Direction::UNDEFINED);
+			if (updateNeighbors) {
+				scheduleEditNeighborUpdates(region, pos, [&editedPositions](const glm::ivec3& nPos) -> bool {
+					return editedPositions.find(nPos) != editedPositions.end();
+				});
+			}
+		}
+		return true;
+	}
+
+	template<typename F>
+	void World::scheduleEditNeighborUpdates(WorldRegionView& region, const glm::ivec3& blockPos, F&& isEdited) {
+		for (const auto dir : direction::directions) {
+			const glm::ivec3 nPos = direction::offsetVector(blockPos, dir);
+			if (isEdited(nPos) || !region.isBlockLoaded(nPos)) continue;
+			scheduleBlockUpdate(nPos, direction::getOpposite(dir));
+			// fluid updates for empty fluidstates are discarded by doFluidUpdates anyway
+			if (!region.getFluidState(nPos).isEmpty()) scheduleFluidUpdate(nPos, direction::getOpposite(dir));
+		}
+	}
+
 	bool World::isChunkLoaded(const ChunkCoord& chunkCoord) const {
-		return loadedChunks.find(chunkCoord) != loadedChunks.end();
+		return loadedChunks.contains(chunkCoord);
 	}
 	Chunk* World::getChunk(const ChunkCoord& chunkCoord) {
-		auto it = loadedChunks.find(chunkCoord);
-		return (it == loadedChunks.end()) ? nullptr : &(it->second);
+		return loadedChunks.find(chunkCoord);
 	}
 	const Chunk* World::getChunk(const ChunkCoord& chunkCoord) const {
-		const auto it = loadedChunks.find(chunkCoord);
-		return (it == loadedChunks.end()) ? nullptr : &(it->second);
+		return loadedChunks.find(chunkCoord);
 	}
 
-	int World::getTerrainHeight(const int x, const int z) const {
-		const auto noise = terrainGenNoise.getNoise({ x, z });
-		//const auto terrainHeight = static_cast<int>(noise * 188) - 94;
-		const auto terrainHeight = static_cast<int>(noise * 512) - 128;
-
-		return terrainHeight;
+	std::optional<int> World::getSurfaceHeight(const int x, const int z) const {
+		const ChunkCoord chunkCoord = ChunkCoord::fromBlockPos({ x, 0, z });
+		const auto it = chunkColumns.find({ chunkCoord.x, chunkCoord.z });
+		if (it == chunkColumns.end()) return std::nullopt;
+		const glm::ivec3 cPos = chunkCoord.getRelativeBlockPos({ x, 0, z });
+		// the column's chunks are sorted from the top, so a chunk that isn't directly below the previous one means a gap
+		int prevChunkY = it->second.front()->getChunkCoord().y + 1;
+		for (const Chunk* const chunk : it->second) {
+			if (chunk->getChunkCoord().y != (prevChunkY - 1)) return std::nullopt; // the surface could be in a chunk that isn't loaded
+			if (const int height = chunk->getHeightmap().get(cPos.x, cPos.z); height != ChunkHeightmap::empty_column)
+				return chunk->getBlockPos().y + height;
+			prevChunkY = chunk->getChunkCoord().y;
+		}
+		return std::nullopt;
 	}
 
 	RayCastResultF World::rayCast(const RayF& ray, RayCastMask mask) const {
@@ -161,15 +433,21 @@ namespace eng {
 		bool hasHit = false;
 
 		for (const auto& [chunkCoord, chunk] : loadedChunks) {
-			if (!chunk.getBoundingBox().intersectRay(ray)) continue;
+			// the bounding box is checked first, so that compressed chunks the ray doesn't pass through aren't decompressed
+			if (!chunk->getBoundingBox().intersectRay(ray)) continue;
+			const bool checkFluids = (mask & RayCastMask::Fluids) != RayCastMask::None;
+			const ChunkHeightmap& heightmap = chunk->getHeightmap();
+			if (!chunk->getSummary().hasBlocks() && (!checkFluids || !chunk->getSummary().hasFluids())) continue; // nothing to hit
 
-			const Chunk::BlockData& chunkBlockData = chunk.getBlockData();
-			const Chunk::FluidData& chunkFluidData = chunk.getFluidData();
+			const Chunk::BlockData& chunkBlockData = chunk->getBlockData();
+			const Chunk::FluidData& chunkFluidData = chunk->getFluidData();
 
 			if ((mask & (RayCastMask::Blocks | RayCastMask::Fluids)) != RayCastMask::None) {
 				for (size_t i = 0; i < Chunk::SIZE; i++) {
 					// TODO: skip blocks & fluids outside of the aabb from origin to (origin + (direction * range))?
-					const auto blockPos = chunk.getBlockPos() + Chunk::indexToPos(i);
+					const glm::ivec3 cPos = Chunk::indexToPos(i);
+					if (!checkFluids && (cPos.y > heightmap.get(cPos.x, cPos.z))) continue; // the block is above the column's topmost block
+					const auto blockPos = chunk->getBlockPos() + cPos;
 					{ // Blocks
 						const auto& blockState = chunkBlockData[i];
 						const auto box = blockState.getBlock().getSelectionBox(*this, blockState, blockPos) + blockPos;
@@ -183,7 +461,7 @@ namespace eng {
 							hasHit = true;
 						}
 					}
-					if ((mask & RayCastMask::Fluids) != RayCastMask::None) { // Fluids
+					if (checkFluids) { // Fluids
 						const auto& fluidState = chunkFluidData[i];
 						const auto box = fluidState.getFluid().getBoundingBox(*this, fluidState, blockPos) + blockPos;
 
@@ -217,29 +495,122 @@ namespace eng {
 		return {}; // no result
 	}
 
-	void World::loadChunk(const ChunkCoord& chunkCoord) {
-		loadedChunks.try_emplace(chunkCoord, this, chunkCoord);
+	// returns the sub-regions of the chunk in direction d from a chunk that touch that chunk
+	static Chunk::RegionMask getNeighborFaceRegions(const Direction d) {
+		constexpr int maxPos = static_cast<int>(Chunk::WIDTH - 1);
+		const auto axisIndex = getIndex(direction::getAxis(d));
+		glm::ivec3 faceMin { 0, 0, 0 };
+		glm::ivec3 faceMax { maxPos, maxPos, maxPos };
+		if (direction::getAxisDirection(d) == AxisDirection::POSITIVE)
+			faceMax[axisIndex] = 0; // the neighbor's negative face
+		else
+			faceMin[axisIndex] = maxPos; // the neighbor's positive face
+		return Chunk::getRegionMask(faceMin, faceMax);
+	}
+
+	void World::loadChunk(const ChunkCoord& chunkCoord, Chunk::Contents&& contents) {
+		if (isChunkLoaded(chunkCoord)) return;
+		Chunk* const chunk = chunkPool.create(this, chunkCoord, std::move(contents));
+		loadedChunks.insert(chunkCoord, chunk);
+		std::vector<Chunk*>& column = chunkColumns[{ chunkCoord.x, chunkCoord.z }];
+		column.insert(std::find_if(column.begin(), column.end(), [&chunkCoord](const Chunk* const c) { return c->getChunkCoord().y < chunkCoord.y; }), chunk);
 		scheduleChunkRemesh(chunkCoord, MeshingPriority::ChunkLoad);
-		// schedule neighbor chunks for re-meshing
+		// schedule the sub-regions of neighbor chunks that touch this chunk for re-meshing
 		for (const Direction d : direction::directions)
-			scheduleChunkRemesh(chunkCoord.offset(d), MeshingPriority::ChunkLoad);
+			scheduleChunkRemesh(chunkCoord.offset(d), MeshingPriority::ChunkLoad, false, getNeighborFaceRegions(d));
 	}
 	void World::unloadChunk(const ChunkCoord& chunkCoord) {
-		// schedule neighbor chunks for re-meshing
+		if (!isChunkLoaded(chunkCoord)) return; // e.g. the chunk was scheduled for unloading twice
+		// the chunk can be loaded again if it comes back into range
+		loadCursor = std::min(loadCursor, getFirstLoadCandidateIndex(load_candidate_offsets,
+				std::sqrt(static_cast<float>(lengthSquared(static_cast<glm::ivec3>(chunkCoord) - static_cast<glm::ivec3>(playerChunkCoord))))));
+		// schedule the sub-regions of neighbor chunks that touch this chunk for re-meshing
 		for (const Direction d : direction::directions)
-			scheduleChunkRemesh(chunkCoord.offset(d), MeshingPriority::ChunkUnload);
-		loadedChunks.erase(chunkCoord);
+			scheduleChunkRemesh(chunkCoord.offset(d), MeshingPriority::ChunkUnload, false, getNeighborFaceRegions(d));
+		if (Chunk* const chunk = loadedChunks.erase(chunkCoord); chunk) {
+			if (auto it = chunkColumns.find({ chunkCoord.x, chunkCoord.z }); it != chunkColumns.end()) {
+				std::erase(it->second, chunk);
+				if (it->second.empty()) chunkColumns.erase(it);
+			}
+			if (chunk->isCompressed()) {
+				chunkCompressor.recordRelease(*chunk->compressedContents);
+				// the compressed data is saved as is, so that it isn't decompressed on the main thread just to be written
+				if (chunk->isModified()) chunkStorage.saveChunk(chunkCoord, std::move(chunk->compressedContents));
+			} else if (chunk->isModified()) {
+				chunkStorage.saveChunk(*chunk);
+			}
+			chunkPool.destroy(chunk);
+		}
 	}
 
 	bool World::canLoadChunk(const ChunkCoord& chunkCoord) const {
-		const glm::ivec3 chunkCenter { ChunkCoord::toBlockPos(chunkCoord) + glm::ivec3(Chunk::WIDTH / 2, Chunk::WIDTH / 2, Chunk::WIDTH / 2) };
-		const auto distSqr = glm::distance2(static_cast<glm::vec3>(chunkCenter), player->getPosition());
-		return distSqr <= static_cast<float>(loading_dist_sqr);
+		// chunks in range of the player's predicted position are prefetched
+		const int loadingRadiusSqr = loading_chunk_radius * loading_chunk_radius;
+		return (lengthSquared(static_cast<glm::ivec3>(chunkCoord) - static_cast<glm::ivec3>(playerChunkCoord)) <= loadingRadiusSqr) ||
+				(lengthSquared(static_cast<glm::ivec3>(chunkCoord) - static_cast<glm::ivec3>(predictedChunkCoord)) <= loadingRadiusSqr);
+	}
+
+	void World::updateLoadCursor(const ChunkCoord& prevPlayerChunkCoord, const ChunkCoord& prevPredictedChunkCoord, const bool playerJumped) {
+		if (playerJumped || (loadCursorRadius != loading_chunk_radius)) {
+			loadCursor = 0;
+			loadCursorRadius = loading_chunk_radius;
+			return;
+		}
+		const float loadingRadius = static_cast<float>(loading_chunk_radius);
+		if (playerChunkCoord != prevPlayerChunkCoord) {
+			// the player moved by at most one chunk on each axis (sqrt(3) chunks), so the chunks that are closer to the new chunk than the previous
+			// cursor position and the loading radius (minus that distance) were loaded before the player moved
+			const float cursorDist = (loadCursor < load_candidate_offsets.size()) ? std::sqrt(static_cast<float>(lengthSquared(load_candidate_offsets[loadCursor]))) : loadingRadius;
+			loadCursor = std::min(loadCursor, getFirstLoadCandidateIndex(load_candidate_offsets, std::min(cursorDist, loadingRadius) - std::sqrt(3.0f)));
+		}
+		if (predictedChunkCoord != prevPredictedChunkCoord) {
+			// only chunks outside of the player's loading radius can be prefetched
+			loadCursor = std::min(loadCursor, player_load_candidate_count);
+		}
 	}
 	bool World::shouldUnloadChunk(const ChunkCoord& chunkCoord) const {
-		const glm::vec3 chunkCenter { ChunkCoord::toBlockPos(chunkCoord) + glm::ivec3(Chunk::WIDTH / 2, Chunk::WIDTH / 2, Chunk::WIDTH / 2) };
-		const auto distSqr = glm::distance2(chunkCenter, player->getPosition());
-		return distSqr > static_cast<float>(unloading_dist_sqr);
+		return lengthSquared(static_cast<glm::ivec3>(chunkCoord) - static_cast<glm::ivec3>(playerChunkCoord)) > (unloading_chunk_radius * unloading_chunk_radius);
+	}
+
+	void World::compressIdleChunks() {
+		// swap in the compressed data, unless the chunk was accessed since it was queued (or its data was replaced)
+		for (auto& result : chunkCompressor.takeCompleted()) {
+			Chunk* const chunk = getChunk(result.chunkCoord);
+			if (!chunk || chunk->accessed || chunk->isCompressed() || (chunk->blockData != result.blockData) || (chunk->fluidData != result.fluidData))
+				continue;
+			chunkCompressor.recordCompression(*result.contents);
+			chunk->compressedContents = std::move(result.contents);
+			chunk->blockData.reset();
+			chunk->fluidData.reset();
+		}
+
+		for (size_t i = 0, sweepSize = std::min(compression_sweep_size, loadedChunks.size()); i < sweepSize; i++) {
+			if (compressionSweepCursor >= loadedChunks.size()) {
+				chunkDataMemoryUsage = sweepDataMemoryUsage;
+				sweepDataMemoryUsage = 0;
+				compressionSweepCursor = 0;
+				// only compress enough chunks to get under the budget, which the next sweep measures again
+				compressionAllowance = (chunkDataMemoryUsage > chunk_memory_budget) ? (chunkDataMemoryUsage - chunk_memory_budget) : 0;
+			}
+			Chunk* const chunk = (loadedChunks.begin() + compressionSweepCursor++)->second;
+			// the chunk's data was accessed at some point since the sweep last checked it
+			if (chunk->accessed) {
+				chunk->accessed = false;
+				chunk->lastAccessTick = ticks;
+			}
+			const size_t memoryUsage = chunk->getDataMemoryUsage();
+			sweepDataMemoryUsage += memoryUsage;
+			// uniform chunks are already as small as they can be
+			if ((compressionAllowance == 0) || chunk->isCompressed() || chunk->isUniform() || ((ticks - chunk->lastAccessTick) < chunk_compression_delay))
+				continue;
+			if (chunkCompressor.enqueue(chunk->getChunkCoord(), chunk->blockData, chunk->fluidData))
+				compressionAllowance -= std::min(compressionAllowance, memoryUsage);
+		}
+	}
+
+	void World::setChunkCompression(const uint64_t delayTicks, const size_t memoryBudget) noexcept {
+		World::chunk_compression_delay = delayTicks;
+		World::chunk_memory_budget = memoryBudget;
 	}
 
 	void World::setChunkLoadRadius(const int loadRadius) noexcept {
@@ -247,17 +618,70 @@ namespace eng {
 		World::loading_dist_sqr = World::loading_dist * World::loading_dist;
 		World::unloading_dist = World::loading_dist + 32;
 		World::unloading_dist_sqr = World::unloading_dist * World::unloading_dist;
+
+		// chunks are loaded and unloaded based on the distance between chunk coordinates, so that the chunks in range only change when the player
+		// (or the player's predicted position) crosses a chunk boundary. the predicted position is at most one chunk away on each axis,
+		// so prefetched chunks are less than two chunks further away than the loading radius
+		World::loading_chunk_radius = (World::loading_dist + static_cast<int>(Chunk::WIDTH / 2)) / static_cast<int>(Chunk::WIDTH);
+		const int radius = World::loading_chunk_radius + 2;
+		World::unloading_chunk_radius = radius;
+		World::unloading_shell_offsets.clear();
+		World::load_candidate_offsets.clear();
+		const int radiusSqr = radius * radius;
+		const int loadingRadiusSqr = World::loading_chunk_radius * World::loading_chunk_radius;
+		for (int z = -radius; z <= radius; z++) {
+			for (int y = -radius; y <= radius; y++) {
+				for (int x = -radius; x <= radius; x++) {
+					const glm::ivec3 offset { x, y, z };
+					if (lengthSquared(offset) > radiusSqr) continue;
+					// whether moving the player by one chunk can move the offset out of range
+					const glm::ivec3 outer = glm::abs(offset) + 1;
+					if (lengthSquared(outer) > radiusSqr)
+						World::unloading_shell_offsets.push_back(offset);
+					// whether the offset is in loading range of a predicted chunk next to the player's chunk
+					const glm::ivec3 inner = glm::max(glm::abs(offset) - 1, 0);
+					if (lengthSquared(inner) <= loadingRadiusSqr)
+						World::load_candidate_offsets.push_back(offset);
+				}
+			}
+		}
+		std::stable_sort(World::load_candidate_offsets.begin(), World::load_candidate_offsets.end(), [](const glm::ivec3& a, const glm::ivec3& b) {
+			return lengthSquared(a) < lengthSquared(b);
+		});
+		World::player_load_candidate_count = static_cast<size_t>(std::partition_point(World::load_candidate_offsets.begin(), World::load_candidate_offsets.end(), [loadingRadiusSqr](const glm::ivec3& offset) {
+			return lengthSquared(offset) <= loadingRadiusSqr;
+		}) - World::load_candidate_offsets.begin());
 	}
 
 
-	void World::scheduleChunkRemesh(const ChunkCoord& chunkCoord, const MeshingPriority meshingPriority, const bool onlyFluid) {
+	void World::scheduleChunkRemesh(const ChunkCoord& chunkCoord, const MeshingPriority meshingPriority, const bool onlyFluid, const Chunk::RegionMask regions) {
+		if (regions == 0) return;
 		if (auto it = dirtyChunks.find(chunkCoord); it != dirtyChunks.end()) {
 			const auto [cc, prevPriority] = *it;
 			it->second.fluidOnly &= onlyFluid;
+			it->second.regions |= regions;
 			if (meshingPriority < prevPriority.priority)
 				it->second.priority = meshingPriority;
 		} else {
-			dirtyChunks[chunkCoord] = { meshingPriority, onlyFluid };
+			dirtyChunks[chunkCoord] = { meshingPriority, onlyFluid, regions };
+		}
+	}
+
+	void World::scheduleRemeshAround(const glm::ivec3& minPos, const glm::ivec3& maxPos, const MeshingPriority meshingPriority, const bool onlyFluid) {
+		// the mesh of a block can depend on the blocks adjacent to it
+		const glm::ivec3 boxMin = minPos - 1;
+		const glm::ivec3 boxMax = maxPos + 1;
+		const ChunkCoord minChunk = ChunkCoord::fromBlockPos(boxMin);
+		const ChunkCoord maxChunk = ChunkCoord::fromBlockPos(boxMax);
+		for (int cz = minChunk.z; cz <= maxChunk.z; cz++) {
+			for (int cy = minChunk.y; cy <= maxChunk.y; cy++) {
+				for (int cx = minChunk.x; cx <= maxChunk.x; cx++) {
+					const ChunkCoord chunkCoord { cx, cy, cz };
+					if (!isChunkLoaded(chunkCoord)) continue;
+					const glm::ivec3 chunkPos = chunkCoord.getBlockPos();
+					scheduleChunkRemesh(chunkCoord, meshingPriority, onlyFluid, Chunk::getRegionMask(boxMin - chunkPos, boxMax - chunkPos));
+				}
+			}
 		}
 	}
 
@@ -275,10 +699,12 @@ namespace eng {
 
 	void World::doBlockUpdates() {
 		currentTickBlockUpdates.clear();
+		WorldRegionView region(*this, {});
 		for (auto it = scheduledBlockUpdates.begin(); it != scheduledBlockUpdates.end();) {
 			auto& [blockPos, scheduledUpdate] = *it;
 			if (scheduledUpdate.delay == 0) {
-				if (isBlockLoaded(blockPos))
+				region.recenter(blockPos);
+				if (region.isBlockLoaded(blockPos))
 					currentTickBlockUpdates.push_back(scheduledUpdate.blockUpdate);
 				else
 					cacheBlockUpdate(scheduledUpdate.blockUpdate);
@@ -289,7 +715,8 @@ namespace eng {
 			it++;
 		}
 		for (const auto& blockUpdate : currentTickBlockUpdates) {
-			const BlockState& blockState = getBlockState(blockUpdate.blockPos);
+			region.recenter(blockUpdate.blockPos);
+			const BlockState blockState = region.getBlockState(blockUpdate.blockPos);
 			blockState.getBlock().onBlockUpdate(*this, blockState, blockUpdate.blockPos, blockUpdate.srcDirection);
 		}
 	}
@@ -319,11 +746,13 @@ namespace eng {
 	void World::doFluidUpdates() {
 		const auto prevUpdateCount = currentTickFluidUpdates.size();
 		currentTickFluidUpdates.clear();
+		WorldRegionView region(*this, {});
 		for (auto it = scheduledFluidUpdates.begin(); it != scheduledFluidUpdates.end();) {
 			auto& [blockPos, scheduledUpdate] = *it;
 			if (scheduledUpdate.delay == 0) {
-				if (isBlockLoaded(blockPos)) {
-					if (getFluidState(blockPos).isEmpty()) {
+				region.recenter(blockPos);
+				if (const Chunk* const chunk = region.getChunk(blockPos); chunk) {
+					if (!chunk->getSummary().hasFluids() || chunk->getLocalFluidState(blockPos - chunk->getBlockPos()).isEmpty()) {
 					} else if (currentTickFluidUpdates.size() < max_fluid_updates) {
 						currentTickFluidUpdates.push_back(scheduledUpdate.blockUpdate);
 					} else {
@@ -343,7 +772,8 @@ namespace eng {
 		//if (updateCount != prevUpdateCount)
 		//	std::cout << "Fluid Updates: " << updateCount << '\n';
 		for (const auto& fluidUpdate : currentTickFluidUpdates) {
-			const FluidState& fluidState = getFluidState(fluidUpdate.blockPos);
+			region.recenter(fluidUpdate.blockPos);
+			const FluidState fluidState = region.getFluidState(fluidUpdate.blockPos);
 			fluidState.getFluid().onFluidUpdate(*this, fluidState, fluidUpdate.blockPos, fluidUpdate.srcDirection);
 		}
 	}
@@ -4,7 +4,11 @@
 #include <map>
 #include <string>
 #include <utility>
+#include <span>
+#include <filesystem>
+#include <optional>
 
+#include <glm/vec2.hpp>
 #include <glm/vec3.hpp>
 
 #define result_of invoke_result
@@ -13,6 +17,14 @@
 #include "block/Block.h"
 #include "fluid/Fluid.h"
 #include "chunk/Chunk.h"
+#include "chunk/ChunkPool.h"
+#include "chunk/ChunkIndex.h"
+#include "chunk/ChunkStorage.h"
+#include "chunk/ChunkGenerator.h"
+#include "chunk/ChunkCompressor.h"
+#include "chunk/ChunkLoadBudget.h"
+#include "chunk/ChunkLoadPrioritizer.h"
+#include "chunk/TerrainGenerator.h"
 #include "BlockUpdate.h"
 #include "util/math/RNG.h"
 #include "util/math/NoiseGen.h"
@@ -39,20 +51,25 @@ namespace eng {
 	}
 
 	class WorldRenderer;
+	class WorldRegionView;
 
 	class World {
 		friend class Chunk;
 	public:
-		using ChunkMap = phmap::parallel_flat_hash_map<ChunkCoord, Chunk>;//std::unordered_map<ChunkCoord, Chunk>;
+		using ChunkMap = ChunkIndex; // chunks are owned by the world's ChunkPool
 
 	private:
 		struct DirtyChunkPriority {
 			MeshingPriority priority;
 			bool fluidOnly = false;
+			Chunk::RegionMask regions = Chunk::ALL_REGIONS; // sub-regions of the chunk that need to be remeshed
 		};
 
 		uint64_t ticks = 0;
+		ChunkPool chunkPool;
 		ChunkMap loadedChunks;
+		std::unordered_map<glm::ivec2, std::vector<Chunk*>> chunkColumns; // loaded chunks by chunk (x, z) coordinate, from top to bottom
+		ChunkStorage chunkStorage; // modified chunks are saved when they're unloaded, and loaded instead of being generated
 		std::unordered_map<ChunkCoord, DirtyChunkPriority> dirtyChunks; // chunks that need to be remeshed, and the priority of the meshing task
 
 		std::unordered_multimap<glm::ivec3, ScheduledBlockUpdate> scheduledBlockUpdates;
@@ -66,32 +83,73 @@ namespace eng {
 		WorldRenderer* worldRenderer = nullptr;
 
 		Camera* player = nullptr; // TODO: replace with EntityPlayer*
+		ChunkCoord playerChunkCoord {}; // the chunk the player was in at the start of the last tick
+		ChunkCoord predictedChunkCoord {}; // the chunk the player is predicted to be in, used to prefetch chunks
+		int unloadCheckRadius = -1; // the unloading radius when the loaded chunks were last checked
+		int loadCursorRadius = -1; // the loading radius when loadCursor was last reset
+		size_t loadCursor = 0; // every chunk before this index in load_candidate_offsets is loaded or out of range
+		size_t unloadSweepCursor = 0; // index of the next loaded chunk checked by the round-robin unload sweep
+
+		ChunkLoadBudget chunkLoadBudget; // number of chunks to add to the world each tick
+		ChunkLoadPrioritizer loadPrioritizer; // order to load chunks in
+		std::vector<ChunkCoord> loadCandidates; // chunks that could be loaded this tick, reused between ticks
+
+		ChunkCompressor chunkCompressor; // compresses the data of chunks that haven't been accessed for a while
+		size_t compressionSweepCursor = 0; // index of the next loaded chunk checked by the compression sweep
+		size_t sweepDataMemoryUsage = 0; // chunk data memory used by the chunks checked so far in the current sweep
+		size_t chunkDataMemoryUsage = 0; // chunk data memory used by all loaded chunks, as of the last complete sweep
+		size_t compressionAllowance = 0; // bytes of chunk data that can still be queued for compression in the current sweep
 
 	public:
 		const RNG::seed_t seed;
 
 	private:
-		NoiseGen terrainGenNoise;
+		TerrainGenerator terrainGenerator; // its height cache holds the terrain heights of the chunk columns around the player
+		ChunkGenerator chunkGenerator; // declared after everything that generation reads, so that its threads are stopped first
 		static inline int loading_dist {};
 		static inline int loading_dist_sqr {};
 		static inline int unloading_dist {};
 		static inline int unloading_dist_sqr {};
+		static inline int loading_chunk_radius {}; // in chunks, measured between chunk coordinates
+		static inline int unloading_chunk_radius {}; // in chunks, measured between chunk coordinates
+		// offsets from the player's chunk of every chunk that can be in loading range of the player or of the player's predicted position,
+		// sorted by distance
+		static inline std::vector<glm::ivec3> load_candidate_offsets {};
+		static inline size_t player_load_candidate_count {}; // the number of offsets in load_candidate_offsets in the player's loading radius
+		// offsets from the player's chunk of the chunks in the unloading radius that can leave it when the player moves by one chunk
+		static inline std::vector<glm::ivec3> unloading_shell_offsets {};
+		static inline uint64_t chunk_compression_delay { 600 }; // ticks that a chunk has to go unaccessed before it can be compressed
+		static inline size_t chunk_memory_budget { 256 << 20 }; // bytes of chunk data to keep before idle chunks are compressed
 	public:
 		static void setChunkLoadRadius(const int loadRadius) noexcept;
+		// idle chunks are only compressed while the loaded chunks' data uses more than memoryBudget bytes
+		static void setChunkCompression(const uint64_t delayTicks, const size_t memoryBudget) noexcept;
 		static inline int getChunkLoadingDist() noexcept { return loading_dist; }
 		static inline int getChunkLoadingDistSquared() noexcept { return loading_dist_sqr; }
 		static inline int getChunkUnloadingDist() noexcept { return unloading_dist; }
 		static inline int getChunkUnloadingDistSquared() noexcept { return unloading_dist_sqr; }
+		// chunks are loaded when the distance between their chunk coordinate and the player's (or the predicted player position's) is at most this
+		static inline int getChunkLoadingRadius() noexcept { return loading_chunk_radius; }
+		// chunks are unloaded when the distance between their chunk coordinate and the player's is greater than this
+		static inline int getChunkUnloadingRadius() noexcept { return unloading_chunk_radius; }
 
-		static size_t maxChunkLoads; // maximum number of chunks to load per tick
 
 
 		World(RNG::seed_t seed = RNG::randomSeed());
+		// gradientMode picks how the terrain noise is computed (see NoiseGen::GradientMode)
+		World(RNG::seed_t seed, std::filesystem::path saveDirectory, NoiseGen::GradientMode gradientMode = NoiseGen::GradientMode::Permutation);
 		World(std::string_view seed) : World(RNG::toSeed(seed)) {}
 
+		World(const World&) = delete;
+		World& operator =(const World&) = delete;
+
+		~World();
+
 
 		inline RNG::seed_t getSeed() const noexcept { return seed; }
 
+		static std::filesystem::path getDefaultSaveDirectory(RNG::seed_t seed);
+
 		void setPlayer(Camera* player) noexcept {
 			this->player = player;
 		}
@@ -106,12 +164,51 @@ namespace eng {
 
 		void update();
 
-		BlockStateRef getBlockState(const glm::ivec3& blockPos) const;
+		// time since the previous frame, used to adjust the chunk load budget
+		inline void reportFrameTime(const ChunkLoadBudget::duration frameTime) noexcept {
+			chunkLoadBudget.reportFrameTime(frameTime);
+		}
+		inline const ChunkLoadBudget& getChunkLoadBudget() const noexcept { return chunkLoadBudget; }
+		inline const ChunkCompressor::Stats& getChunkCompressionStats() const noexcept { return chunkCompressor.getStats(); }
+		// approximate bytes of heap memory used by the data of the loaded chunks, as of the last complete compression sweep
+		// it is only refreshed at the end of each sweep, so it can lag behind loading and unloading by up to a sweep
+		inline size_t getChunkDataMemoryUsage() const noexcept { return chunkDataMemoryUsage; }
+		// calls f with each chunk in the loading radius of the player's chunk (as of the last tick) that isn't loaded
+		// the chunks before the load cursor are all loaded, so only the ones after it are checked
+		template<typename F>
+		void forEachMissingChunk(F&& f) const {
+			for (size_t i = loadCursor; i < player_load_candidate_count; i++) {
+				const ChunkCoord chunkCoord { playerChunkCoord + load_candidate_offsets[i] };
+				if (!isChunkLoaded(chunkCoord)) f(chunkCoord);
+			}
+		}
+		inline const TerrainGenerator& getTerrainGenerator() const noexcept { return terrainGenerator; }
+		inline TerrainHeightCache::Stats getTerrainHeightCacheStats() const { return terrainGenerator.getHeightCacheStats(); }
+		// the number of enqueued chunks that are still generating, and of the partially generated chunks kept for them (including their neighbors)
+		inline size_t getGeneratingChunkCount() const { return chunkGenerator.queuedTasks(); }
+		inline size_t getProtoChunkCount() const { return chunkGenerator.getProtoChunkCount(); }
+
+		BlockState getBlockState(const glm::ivec3& blockPos) const;
 		bool setBlockState(const glm::ivec3& blockPos, BlockStateRef blockState, bool remesh = true, bool updateNeighbors = true, bool scheduleFluidUpdate = true, MeshingPriority meshingPriority = MeshingPriority::BlockUpdate);
 
-		FluidStateRef getFluidState(const glm::ivec3& blockPos) const;
+		FluidState getFluidState(const glm::ivec3& blockPos) const;
 		bool setFluidState(const glm::ivec3& blockPos, FluidStateRef fluidState, bool remesh = true, bool updateNeighbors = true, bool scheduleUpdate = true, MeshingPriority meshingPriority = MeshingPriority::FluidUpdate);
 
+		// bulk edits
+		// these write directly into the data of each loaded chunk they touch, schedule a single remesh per touched chunk,
+		// and only schedule block & fluid updates around the boundary of the edited blocks
+		// blocks in unloaded chunks are skipped
+		// return true if any block was changed
+
+		// minPos and maxPos are inclusive
+		// only the blocks surrounding the box are updated, not the blocks inside of it
+		bool fillBox(const glm::ivec3& minPos, const glm::ivec3& maxPos, BlockStateRef blockState, bool updateNeighbors = true, MeshingPriority meshingPriority = MeshingPriority::BlockUpdate);
+		// replaces every instance of target within the box with replacement
+		// minPos and maxPos are inclusive
+		bool replaceInBox(const glm::ivec3& minPos, const glm::ivec3& maxPos, BlockStateRef target, BlockStateRef replacement, bool updateNeighbors = true, MeshingPriority meshingPriority = MeshingPriority::BlockUpdate);
+		// if a position appears multiple times, the last blockstate for that position is used
+		bool setBlocks(std::span<const std::pair<glm::ivec3, BlockState>> blocks, bool updateNeighbors = true, MeshingPriority meshingPriority = MeshingPriority::BlockUpdate);
+
 		bool isChunkLoaded(const ChunkCoord&) const;
 		inline bool isBlockLoaded(const glm::ivec3& blockPos) const {
 			return isChunkLoaded(ChunkCoord::fromBlockPos(blockPos));
@@ -126,9 +223,16 @@ namespace eng {
 
 		void scheduleFluidUpdate(const glm::ivec3& blockPos, Direction srcDir, uint16_t delay = 0);
 
-		void scheduleChunkRemesh(const ChunkCoord& chunkCoord, const MeshingPriority meshingPriority, bool onlyFluid = false);
+		void scheduleChunkRemesh(const ChunkCoord& chunkCoord, const MeshingPriority meshingPriority, bool onlyFluid = false, Chunk::RegionMask regions = Chunk::ALL_REGIONS);
+		// schedules remeshing of the chunk sub-regions whose meshes may depend on the blocks in the box [minPos, maxPos]
+		// minPos and maxPos are inclusive block positions in world coordinates
+		void scheduleRemeshAround(const glm::ivec3& minPos, const glm::ivec3& maxPos, const MeshingPriority meshingPriority, bool onlyFluid = false);
 
-		int getTerrainHeight(const int x, const int z) const;
+		inline int getTerrainHeight(const int x, const int z) const { return terrainGenerator.getTerrainHeight(x, z); }
+		inline int getDensitySurfaceHeight(const int x, const int z) const { return terrainGenerator.getDensitySurfaceHeight(x, z); }
+		// returns the y coordinate of the topmost non-empty block in the loaded chunks at (x, z), treating the chunks above the topmost loaded one
+		// as empty. returns nullopt if the loaded part of the column is empty, or if a chunk above the surface isn't loaded
+		std::optional<int> getSurfaceHeight(const int x, const int z) const;
 
 	protected:
 
@@ -136,16 +240,27 @@ namespace eng {
 
 		void doFluidUpdates();
 
-		void loadChunk(const ChunkCoord&);
+		// adds a chunk whose contents were loaded from disk or generated
+		void loadChunk(const ChunkCoord&, Chunk::Contents&& contents);
 		void unloadChunk(const ChunkCoord&);
 
 		bool canLoadChunk(const ChunkCoord&) const;
+		// moves the load cursor back to the first chunk that may have come into range
+		void updateLoadCursor(const ChunkCoord& prevPlayerChunkCoord, const ChunkCoord& prevPredictedChunkCoord, bool playerJumped);
 		bool shouldUnloadChunk(const ChunkCoord&) const;
 
+		// swaps compressed data into the chunks that finished compressing, and queues a few idle chunks for compression
+		void compressIdleChunks();
+
 		void cacheBlockUpdate(const BlockUpdate& blockUpdate);
 
 		void cacheFluidUpdate(const FluidUpdate& fluidUpdate);
 
+		// schedules block & fluid updates for the neighbors of an edited block that weren't edited themselves
+		// isEdited(pos) returns true if the block at pos was part of the edit
+		template<typename F>
+		void scheduleEditNeighborUpdates(WorldRegionView& region, const glm::ivec3& blockPos, F&& isEdited);
+
 	};
 
 }
\ No newline at end of file
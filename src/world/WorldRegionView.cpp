@@ -0,0 +1,61 @@
+#include "WorldRegionView.h"
+
+#include "World.h"
+#include "block/BlockRegistry.h"
+#include "fluid/FluidRegistry.h"
+
+namespace eng {
+
+	WorldRegionView::WorldRegionView(World& world, const glm::ivec3& centerBlockPos) noexcept :
+			world(&world),
+			centerCoord(ChunkCoord::fromBlockPos(centerBlockPos)) {}
+
+	void WorldRegionView::recenter(const glm::ivec3& blockPos) noexcept {
+		const ChunkCoord chunkCoord = ChunkCoord::fromBlockPos(blockPos);
+		if (chunkCoord == centerCoord) return;
+		centerCoord = chunkCoord;
+		fetchedChunks = 0;
+	}
+
+	Chunk* WorldRegionView::getChunk(const glm::ivec3& blockPos) const {
+		const int rx = (blockPos.x >> Chunk::LOG2_WIDTH) - centerCoord.x + 1;
+		const int ry = (blockPos.y >> Chunk::LOG2_WIDTH) - centerCoord.y + 1;
+		const int rz = (blockPos.z >> Chunk::LOG2_WIDTH) - centerCoord.z + 1;
+		if ((static_cast<unsigned>(rx) >= 3) || (static_cast<unsigned>(ry) >= 3) || (static_cast<unsigned>(rz) >= 3))
+			return world->getChunk(ChunkCoord::fromBlockPos(blockPos)); // outside of the cached region
+		const int i = (rx * 9) + (rz * 3) + ry;
+		const uint32_t bit = uint32_t{1} << i;
+		if (!(fetchedChunks & bit)) {
+			chunks[i] = world->getChunk(ChunkCoord(centerCoord.x + rx - 1, centerCoord.y + ry - 1, centerCoord.z + rz - 1));
+			fetchedChunks |= bit;
+		}
+		return chunks[i];
+	}
+
+	BlockState WorldRegionView::getBlockState(const glm::ivec3& blockPos) const {
+		if (const Chunk* const chunk = getChunk(blockPos); chunk)
+			return chunk->getLocalBlockState(blockPos - chunk->getBlockPos());
+		return blocks::empty_blockstate;
+	}
+	bool WorldRegionView::setBlockState(const glm::ivec3& blockPos, BlockStateRef blockState, const bool remesh, const bool updateNeighbors, const bool scheduleFluidUpdate, const MeshingPriority meshingPriority) {
+		if (Chunk* const chunk = getChunk(blockPos); chunk) {
+			chunk->setBlockState(blockPos, blockState, remesh, updateNeighbors, scheduleFluidUpdate, meshingPriority);
+			return true;
+		}
+		return false;
+	}
+
+	FluidState WorldRegionView::getFluidState(const glm::ivec3& blockPos) const {
+		if (const Chunk* const chunk = getChunk(blockPos); chunk)
+			return chunk->getLocalFluidState(blockPos - chunk->getBlockPos());
+		return fluids::empty_fluidstate;
+	}
+	bool WorldRegionView::setFluidState(const glm::ivec3& blockPos, FluidStateRef fluidState, const bool remesh, const bool updateNeighbors, const bool scheduleUpdate, const MeshingPriority meshingPriority) {
+		if (Chunk* const chunk = getChunk(blockPos); chunk) {
+			chunk->setFluidState(blockPos, fluidState, remesh, updateNeighbors, scheduleUpdate, meshingPriority);
+			return true;
+		}
+		return false;
+	}
+
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include <glm/vec3.hpp>
+
+#include "block/BlockState.h"
+#include "fluid/FluidState.h"
+#include "chunk/Chunk.h"
+#include "chunk/ChunkCoord.h"
+#include "render/world/chunk/MeshingPriority.h"
+
+namespace eng {
+
+	class World;
+
+	/*
+	 * Block and fluid accessor for code that works on many positions around a single block, e.g. block and fluid updates.
+	 * Caches pointers to the 3x3x3 chunks around the chunk containing the center position, so that accesses within
+	 * that region resolve to index math instead of a chunk map lookup. Accesses outside of the region fall back to the World.
+	 * Chunks are looked up lazily, the first time a position inside them is accessed.
+	 * A view must not be used after any chunk is loaded or unloaded.
+	 */
+	class WorldRegionView {
+	private:
+		World* world;
+		ChunkCoord centerCoord;
+		mutable std::array<Chunk*, 27> chunks {}; // indexed by ((x + 1) * 9) + ((z + 1) * 3) + (y + 1), relative to centerCoord
+		mutable uint32_t fetchedChunks = 0; // bitmask of the entries of chunks that have been looked up
+
+	public:
+		WorldRegionView(World& world, const glm::ivec3& centerBlockPos) noexcept;
+
+		inline World& getWorld() const noexcept { return *world; }
+		inline const ChunkCoord& getCenterChunkCoord() const noexcept { return centerCoord; }
+
+		// moves the region so that it is centered on the chunk containing blockPos
+		// does nothing if blockPos is in the current center chunk
+		void recenter(const glm::ivec3& blockPos) noexcept;
+
+		// returns the chunk containing blockPos, or nullptr if that chunk isn't loaded
+		Chunk* getChunk(const glm::ivec3& blockPos) const;
+
+		inline bool isBlockLoaded(const glm::ivec3& blockPos) const { return getChunk(blockPos) != nullptr; }
+
+		BlockState getBlockState(const glm::ivec3& blockPos) const;
+		bool setBlockState(const glm::ivec3& blockPos, BlockStateRef blockState, bool remesh = true, bool updateNeighbors = true, bool scheduleFluidUpdate = true, MeshingPriority meshingPriority = MeshingPriority::BlockUpdate);
+
+		FluidState getFluidState(const glm::ivec3& blockPos) const;
+		bool setFluidState(const glm::ivec3& blockPos, FluidStateRef fluidState, bool remesh = true, bool updateNeighbors = true, bool scheduleUpdate = true, MeshingPriority meshingPriority = MeshingPriority::FluidUpdate);
+
+	};
+
+}
@@ -10,31 +10,33 @@
 #include "block/BlockRegistry.h"
 #include "fluid/FluidRegistry.h"
 #include "model/block/BlockModel.h"
-#include "util/math/RNG.h"
 
-#include <chrono> // TODO: remove
+#include <chrono>
 #include <iostream> // TODO: remove
 
 namespace eng {
 
-	Chunk::Chunk(World* const world, const ChunkCoord& coord) :
+	Chunk::Chunk(World* const world, const ChunkCoord& coord, Contents&& contents) :
+			blockData(std::move(contents.blockData)),
+			fluidData(std::move(contents.fluidData)),
+			heightmap(contents.heightmap ? *contents.heightmap : ChunkHeightmap(*blockData)),
+			summary(contents.summary ? *contents.summary : ChunkSummary(*blockData, *fluidData)),
 			renderChunk(std::make_shared<RenderChunk>(coord)),
 			world(world),
 			chunkCoord(coord),
 			blockPos(ChunkCoord::toBlockPos(coord)),
-			boundingBox(blockPos, blockPos + static_cast<int>(WIDTH)) {
-		generate();
-	}
+			boundingBox(blockPos, blockPos + static_cast<int>(WIDTH)) {}
 
 	inline bool Chunk::containsBlockPos(const glm::ivec3& blockPos) const noexcept {
 		return chunkCoord == ChunkCoord::fromBlockPos(blockPos);
 	}
 
-	BlockStateRef Chunk::getBlockState(const glm::ivec3& pos) const {
+	BlockState Chunk::getBlockState(const glm::ivec3& pos) const {
 		const auto i = posToIndex(pos - blockPos);
 		if (i < 0 || i > SIZE)
 			throw std::out_of_range("Chunk at ChunkCoord " + glm::to_string(static_cast<glm::ivec3>(chunkCoord)) + " does not contain BlockPos " + glm::to_string(pos));
-		return blockData[i];
+		touch();
+		return blockData->get(i);
 	}
 
 	void Chunk::setBlockState(const glm::ivec3& blockPos, BlockStateRef blockState, const bool remesh, const bool updateNeighbors, bool scheduleFluidUpdate, const MeshingPriority meshingPriority) {
@@ -42,23 +44,14 @@ namespace eng {
 		const auto i = posToIndex(rPos);
 		if (i < 0 || i > SIZE)
 			throw std::out_of_range("Chunk at ChunkCoord " + glm::to_string(static_cast<glm::ivec3>(chunkCoord)) + " does not contain BlockPos " + glm::to_string(blockPos));
-		blockData[i] = blockState;
-		if (remesh) {
-			updateMesh(meshingPriority);
-			// schedule neighbor chunks for remeshing if the modified BlockState was on one of the edges of this chunk
-			for (const Axis axis : axis::axes) {
-				const auto axisIndex = getIndex(axis);
-				if (rPos[axisIndex] == 0) {
-					const Direction face = direction::getDirection(axis, AxisDirection::NEGATIVE);
-					Chunk* const chunk = world->getChunk(chunkCoord.offset(face));
-					if (chunk) chunk->updateMesh(meshingPriority);
-				} else if (rPos[axisIndex] == (WIDTH - 1)) {
-					const Direction face = direction::getDirection(axis, AxisDirection::POSITIVE);
-					Chunk* const chunk = world->getChunk(chunkCoord.offset(face));
-					if (chunk) chunk->updateMesh(meshingPriority);
-				}
-			}
+		BlockData& data = getMutableBlockData();
+		const BlockState prevState = data.get(i);
+		if (data.set(i, blockState)) {
+			heightmap.onBlockChanged(data, rPos, blockState.isEmpty());
+			summary.onBlockChanged(rPos, prevState, blockState);
 		}
+		if (remesh) // schedule remeshing of the parts of this chunk and neighboring chunks that can be affected by the change
+			world->scheduleRemeshAround(blockPos, blockPos, meshingPriority);
 		if (scheduleFluidUpdate)
 			world->scheduleFluidUpdate(blockPos, Direction::UNDEFINED);
 		if (updateNeighbors) {
@@ -69,11 +62,12 @@ namespace eng {
 		}
 	}
 
-	FluidStateRef Chunk::getFluidState(const glm::ivec3& pos) const {
+	FluidState Chunk::getFluidState(const glm::ivec3& pos) const {
 		const auto i = posToIndex(pos - blockPos);
 		if (i < 0 || i > SIZE)
 			throw std::out_of_range("Chunk at ChunkCoord " + glm::to_string(static_cast<glm::ivec3>(chunkCoord)) + " does not contain BlockPos " + glm::to_string(pos));
-		return fluidData[i];
+		touch();
+		return fluidData->get(i);
 	}
 
 	void Chunk::setFluidState(const glm::ivec3& blockPos, FluidStateRef fluidState, const bool remesh, const bool updateNeighbors, const bool scheduleUpdate, const MeshingPriority meshingPriority) {
@@ -81,23 +75,11 @@ namespace eng {
 		const auto i = posToIndex(rPos);
 		if (i < 0 || i > SIZE)
 			throw std::out_of_range("Chunk at ChunkCoord " + glm::to_string(static_cast<glm::ivec3>(chunkCoord)) + " does not contain BlockPos " + glm::to_string(blockPos));
-		fluidData[i] = fluidState;
-		if (remesh) {
-			updateMesh(meshingPriority, true);
-			// schedule neighbor chunks for remeshing if the modified FluidState was on one of the edges of this chunk
-			for (const Axis axis : axis::axes) {
-				const auto axisIndex = getIndex(axis);
-				if (rPos[axisIndex] == 0) {
-					const Direction face = direction::getDirection(axis, AxisDirection::NEGATIVE);
-					Chunk* const chunk = world->getChunk(chunkCoord.offset(face));
-					if (chunk) chunk->updateMesh(meshingPriority, true);
-				} else if (rPos[axisIndex] == (WIDTH - 1)) {
-					const Direction face = direction::getDirection(axis, AxisDirection::POSITIVE);
-					Chunk* const chunk = world->getChunk(chunkCoord.offset(face));
-					if (chunk) chunk->updateMesh(meshingPriority, true);
-				}
-			}
-		}
+		FluidData& data = getMutableFluidData();
+		const FluidState prevState = data.get(i);
+		if (data.set(i, fluidState)) summary.onFluidChanged(prevState, fluidState);
+		if (remesh) // schedule remeshing of the parts of this chunk and neighboring chunks that can be affected by the change
+			world->scheduleRemeshAround(blockPos, blockPos, meshingPriority, true);
 		if (scheduleUpdate)
 			world->scheduleFluidUpdate(blockPos, Direction::UNDEFINED);
 		if (updateNeighbors) {
@@ -107,63 +89,88 @@ namespace eng {
 	}
 
 
-	
+	// whether pred(state) is true for any block in the box [cMin, cMax], where cMin and cMax are relative to the chunk
+	template<typename F>
+	static bool anyBlockInBox(const Chunk::BlockData& data, const glm::ivec3& cMin, const glm::ivec3& cMax, F&& pred) {
+		for (int z = cMin.z; z <= cMax.z; z++)
+			for (int y = cMin.y; y <= cMax.y; y++)
+				for (int x = cMin.x; x <= cMax.x; x++)
+					if (pred(data.get(Chunk::posToIndex(x, y, z)))) return true;
+		return false;
+	}
 
-	void Chunk::generate() {
-		// TODO: implement world generator
-		RNG rand(world->getSeed() ^ std::hash<ChunkCoord>{}(chunkCoord));
+	bool Chunk::fillBlocks(const glm::ivec3& cMin, const glm::ivec3& cMax, BlockStateRef blockState) {
+		touch();
+		if (blockData->isUniform() && (blockData->getUniformState() == blockState)) return false;
+		// the data is only copied from the meshing snapshots (and the chunk marked as modified) if a block actually changes
+		if (!anyBlockInBox(*blockData, cMin, cMax, [&](const BlockState state) { return state != blockState; })) return false;
+		const bool wholeChunk = (cMin == glm::ivec3(0, 0, 0)) && (cMax == glm::ivec3(WIDTH - 1, WIDTH - 1, WIDTH - 1));
+		BlockData& data = getMutableBlockData();
+		if (wholeChunk) {
+			data.fill(blockState);
+			heightmap.compute(data);
+			summary.computeBlocks(data);
+			return true;
+		}
+		bool changed = false;
+		for (int z = cMin.z; z <= cMax.z; z++)
+			for (int y = cMin.y; y <= cMax.y; y++)
+				for (int x = cMin.x; x <= cMax.x; x++)
+					changed |= data.set(posToIndex(x, y, z), blockState);
+		if (changed) {
+			heightmap.onBoxChanged(data, cMin, cMax);
+			summary.computeBlocks(data);
+		}
+		return changed;
+	}
 
-		for (size_t z = 0; z < WIDTH; z++) {
-			for (size_t x = 0; x < WIDTH; x++) {
-				const auto terrainHeight = world->getTerrainHeight(x + blockPos.x, z + blockPos.z);
-				for (size_t y = 0; y < WIDTH; y++) {
+	bool Chunk::replaceBlocks(const glm::ivec3& cMin, const glm::ivec3& cMax, BlockStateRef target, BlockStateRef replacement, std::vector<glm::ivec3>& replacedPositions) {
+		if (target == replacement) return false;
+		touch();
+		if (!blockData->contains(target)) return false;
+		if (!anyBlockInBox(*blockData, cMin, cMax, [&](const BlockState state) { return state == target; })) return false;
+		BlockData& data = getMutableBlockData();
+		bool changed = false;
+		for (int z = cMin.z; z <= cMax.z; z++) {
+			for (int y = cMin.y; y <= cMax.y; y++) {
+				for (int x = cMin.x; x <= cMax.x; x++) {
 					const auto i = posToIndex(x, y, z);
-					const int depth = -(static_cast<int>(y) + blockPos.y) +terrainHeight;
-
-					constexpr float tallGrassChance = 0.35f;
-
-					if (depth > 2) blockData[i] = { blocks::stone };
-					else if (depth > 0) blockData[i] = { blocks::dirt };
-					else if (depth == 0) blockData[i] = { blocks::grass };
-					else if ((depth == -1) && (rand.nextFloat() < tallGrassChance)) blockData[i] = { blocks::tall_grass };
+					if (data.get(i) == target) {
+						data.set(i, replacement);
+						replacedPositions.push_back(blockPos + glm::ivec3(x, y, z));
+						changed = true;
+					}
 				}
+			}
+		}
+		if (changed) {
+			heightmap.onBoxChanged(data, cMin, cMax);
+			summary.computeBlocks(data);
+		}
+		return changed;
+	}
 
-				/*const auto isSolid = [&](const glm::ivec3& np) -> bool {
-					return static_cast<int>(world->terrainGenNoise.getNoise(np + blockPos) * 128) < 51;
-				};
-				auto solid = isSolid({ x, WIDTH - 1, z });
-				auto solidAbove1 = isSolid({ x, WIDTH + 0, z });
-				auto solidAbove2 = isSolid({ x, WIDTH + 1, z });
-				auto solidAbove3 = isSolid({ x, WIDTH + 2, z });
-				for (int y = WIDTH - 1; y >= 0; y--) {
-					const auto solidBelow = isSolid({ x, y - 1, z });
-					const auto i = posToIndex(x, y, z);
-
-					if (solid) {
-						if (!solidAbove1) {
-							blockData[i] = { blocks::grass };
-						} else if (!solidAbove2 || !solidAbove3) {
-							blockData[i] = { blocks::dirt };
-						} else {
-							blockData[i] = { blocks::stone };
-						}
-					} else {
-						if (solidBelow) {
-							constexpr float tallGrassChance = 0.35f;
-							if (rand.nextFloat() < tallGrassChance) blockData[i] = { blocks::tall_grass };
-						}
-					}
+	bool Chunk::setLocalBlockState(const glm::ivec3& cPos, BlockStateRef blockState) {
+		const auto i = posToIndex(cPos);
+		touch();
+		const BlockState prevState = blockData->get(i);
+		if (prevState == blockState) return false;
+		if (!getMutableBlockData().set(i, blockState)) return false;
+		heightmap.onBlockChanged(*blockData, cPos, blockState.isEmpty());
+		summary.onBlockChanged(cPos, prevState, blockState);
+		return true;
+	}
 
 
-					solidAbove3 = solidAbove2;
-					solidAbove2 = solidAbove1;
-					solidAbove1 = solid;
-					solid = solidBelow;
-				}*/
-			}
-		}
+	void Chunk::decompress() const {
+		const auto startTime = std::chrono::steady_clock::now();
+		blockData = compressedContents->blockData.decompress();
+		fluidData = compressedContents->fluidData.decompress();
+		world->chunkCompressor.recordDecompression(*compressedContents, std::chrono::steady_clock::now() - startTime);
+		compressedContents.reset();
 	}
 
+
 	inline void Chunk::updateMesh(const MeshingPriority meshingPriority, const bool onlyFluid) {
 		world->scheduleChunkRemesh(chunkCoord, meshingPriority, onlyFluid);
 	}
@@ -3,12 +3,19 @@
 #include <array>
 #include <functional>
 #include <memory>
+#include <atomic>
+#include <vector>
+#include <optional>
 
 #include <glm/vec3.hpp>
 #include <glm/gtc/integer.hpp>
 
 #include "chunk_consts.h"
 #include "ChunkData.h"
+#include "PalettedChunkData.h"
+#include "CompressedChunkData.h"
+#include "ChunkHeightmap.h"
+#include "ChunkSummary.h"
 #include "util/direction.h"
 #include "util/math/math.h"
 #include "block/BlockState.h"
@@ -25,30 +32,69 @@ namespace eng {
 	class ChunkBakery;
 
 	class Chunk {
+		friend class ChunkBakery;
+		friend class World;
 	public:
 		static constexpr size_t WIDTH = chunk_width; // width, depth, and height of a chunk in blocks
 		static constexpr size_t LAYER_SIZE = chunk_layer_size; // number of blocks per 2d slice of the chunk
 		static constexpr size_t SIZE = chunk_volume; // total number of blocks in a chunk
 		static inline constexpr size_t LOG2_WIDTH = chunk_log2_width;
 
-		using BlockData = ChunkData<BlockState, WIDTH>;
-		using FluidData = ChunkData<FluidState, WIDTH>;
+		static constexpr size_t REGION_WIDTH = chunk_region_width; // width, depth, and height of a sub-region in blocks
+		static constexpr size_t REGION_COUNT = chunk_region_count; // number of sub-regions per chunk
+		using RegionMask = chunk_region_mask;
+		static constexpr RegionMask ALL_REGIONS = all_chunk_regions;
+
+		using BlockData = PalettedChunkData<BlockState, WIDTH>;
+		using FluidData = PalettedChunkData<FluidState, WIDTH>;
 		using LightData = ChunkData<BlockLight, WIDTH>;
+
+		// immutable views of a chunk's data, which stay valid (and unchanged) after the chunk is modified or unloaded
+		using BlockDataSnapshot = std::shared_ptr<const BlockData>;
+		using FluidDataSnapshot = std::shared_ptr<const FluidData>;
+
+		// block and fluid data of a chunk that hasn't been added to a world yet (e.g. loaded from disk or generated on another thread)
+		struct Contents {
+			std::shared_ptr<BlockData> blockData;
+			std::shared_ptr<FluidData> fluidData;
+			std::optional<ChunkHeightmap> heightmap; // computed from blockData when the chunk is created if it's missing
+			std::optional<ChunkSummary> summary; // computed from blockData and fluidData when the chunk is created if it's missing
+		};
+		// block and fluid data of a chunk that hasn't been accessed for a while, see ChunkCompressor
+		struct CompressedContents {
+			CompressedChunkData<BlockData> blockData;
+			CompressedChunkData<FluidData> fluidData;
+
+			inline size_t getUncompressedSize() const noexcept { return blockData.getUncompressedSize() + fluidData.getUncompressedSize(); }
+			inline size_t getCompressedSize() const noexcept { return blockData.getCompressedSize() + fluidData.getCompressedSize(); }
+		};
 	private:
-		BlockData blockData;
-		FluidData fluidData;
+		// block and fluid data are copy-on-write: taking a snapshot shares the data,
+		// and the chunk copies it before the next write if a snapshot is still alive
+		// both are null while the chunk is compressed, and the chunk is decompressed the next time its data is accessed
+		mutable std::shared_ptr<BlockData> blockData;
+		mutable std::shared_ptr<FluidData> fluidData;
+		mutable std::unique_ptr<CompressedContents> compressedContents;
+		mutable bool accessed = true; // whether the chunk's data was accessed since the world last checked
+		uint64_t lastAccessTick = 0; // the last world tick that the chunk's data was known to be accessed in
+		ChunkHeightmap heightmap; // updated whenever the block data is modified
+		ChunkSummary summary; // updated whenever the block or fluid data is modified
 		//LightData lightData;
 
 		std::shared_ptr<RenderChunk> renderChunk;
+		bool meshed = false; // whether the last meshing task for this chunk could produce quads
+		uint32_t meshVersion = 0; // incremented for each meshing task, so that stale tasks can't overwrite newer parts of the mesh
+		bool modified = false; // whether the chunk's data has changed since it was generated or loaded
 
-		World* world;
+		World* world; // never null, every chunk belongs to the world that loaded it
 		ChunkCoord chunkCoord;
 		glm::ivec3 blockPos;
 		AxisAlignedBox<int> boundingBox;
 
 	public:
 
-		Chunk(World* const world, const ChunkCoord& coord);
+		// creates a chunk from contents that were loaded or generated elsewhere (chunks are generated on the ChunkGenerator's threads)
+		Chunk(World* const world, const ChunkCoord& coord, Contents&& contents);
 
 		inline World* getWorld() noexcept { return world; }
 		inline const World* getWorld() const noexcept { return world; }
@@ -56,23 +102,66 @@ namespace eng {
 		inline const glm::ivec3& getBlockPos() const noexcept { return blockPos; }
 		inline const AxisAlignedBox<int>& getBoundingBox() const noexcept { return boundingBox; }
 
+		// whether the chunk has to be saved to keep its current contents
+		inline bool isModified() const noexcept { return modified; }
+		// the topmost non-empty block of each column, which can be read without accessing the chunk's data
+		inline const ChunkHeightmap& getHeightmap() const noexcept { return heightmap; }
+		// counts of the chunk's contents, which can be read without accessing the chunk's data
+		inline const ChunkSummary& getSummary() const noexcept { return summary; }
+
+		// whether the chunk's data is compressed in memory
+		inline bool isCompressed() const noexcept { return compressedContents != nullptr; }
+		// approximate number of bytes of heap memory used by the chunk's block and fluid data, without decompressing it
+		inline size_t getDataMemoryUsage() const noexcept {
+			if (compressedContents) return compressedContents->blockData.getMemoryUsage() + compressedContents->fluidData.getMemoryUsage();
+			return blockData->getMemoryUsage() + fluidData->getMemoryUsage();
+		}
+
 
 		inline bool containsBlockPos(const glm::ivec3& blockPos) const noexcept;
 
 		// returns the blockstate at a given world position
 		// pos is a block pos in world coordinates
-		BlockStateRef getBlockState(const glm::ivec3& pos) const;
+		BlockState getBlockState(const glm::ivec3& pos) const;
 		// pos is a block pos in world coordinates
 		void setBlockState(const glm::ivec3& blockPos, BlockStateRef blockState, bool remesh = true, bool updateNeighbors = true, bool scheduleFluidUpdate = true, MeshingPriority meshingPriority = MeshingPriority::BlockUpdate);
 
 		// returns the fluidstate at a given world position
 		// pos is a block pos in world coordinates
-		FluidStateRef getFluidState(const glm::ivec3& pos) const;
+		FluidState getFluidState(const glm::ivec3& pos) const;
 		// pos is a block pos in world coordinates
 		void setFluidState(const glm::ivec3& pos, FluidStateRef fluidState, bool remesh = true, bool updateNeighbors = true, bool scheduleUpdate = true, MeshingPriority meshingPriority = MeshingPriority::FluidUpdate);
 
-		inline const BlockData& getBlockData() const noexcept { return blockData; }
-		inline const FluidData& getFluidData() const noexcept { return fluidData; }
+		// bulk edits used by World::fillBox, World::replaceInBox, and World::setBlocks
+		// these only modify the block data, they don't schedule remeshing or any block or fluid updates
+		// cMin and cMax are relative to chunk origin, and inclusive
+		// returns true if any block was changed
+		bool fillBlocks(const glm::ivec3& cMin, const glm::ivec3& cMax, BlockStateRef blockState);
+		// appends the world position of every replaced block to replacedPositions
+		bool replaceBlocks(const glm::ivec3& cMin, const glm::ivec3& cMax, BlockStateRef target, BlockStateRef replacement, std::vector<glm::ivec3>& replacedPositions);
+		// cPos is relative to chunk origin
+		bool setLocalBlockState(const glm::ivec3& cPos, BlockStateRef blockState);
+
+		// cPos is relative to chunk origin, and isn't bounds checked
+		inline BlockState getLocalBlockState(const glm::ivec3& cPos) const { touch(); return blockData->get(posToIndex(cPos)); }
+		// cPos is relative to chunk origin, and isn't bounds checked
+		inline FluidState getLocalFluidState(const glm::ivec3& cPos) const { touch(); return fluidData->get(posToIndex(cPos)); }
+
+		// whether every block and every fluid in the chunk is the same (e.g. chunks that are entirely air or entirely stone)
+		// a uniform chunk only stores a single blockstate and fluidstate, and is promoted to full storage on the first differing write
+		// uniform chunks are never compressed, so this doesn't decompress the chunk
+		inline bool isUniform() const noexcept { return !compressedContents && blockData->isUniform() && fluidData->isUniform(); }
+		// the blockstate of every block in the chunk if isUniform() is true
+		inline BlockStateRef getUniformBlockState() const { touch(); return blockData->getUniformState(); }
+		// the fluidstate of every block in the chunk if isUniform() is true
+		inline FluidStateRef getUniformFluidState() const { touch(); return fluidData->getUniformState(); }
+
+		inline const BlockData& getBlockData() const { touch(); return *blockData; }
+		inline const FluidData& getFluidData() const { touch(); return *fluidData; }
+
+		// snapshots must only be taken on the thread that modifies the chunk
+		inline BlockDataSnapshot getBlockDataSnapshot() const { touch(); return blockData; }
+		inline FluidDataSnapshot getFluidDataSnapshot() const { touch(); return fluidData; }
 		//inline const LightData& getLightData() const noexcept { return lightData; }
 
 		inline const std::shared_ptr<RenderChunk> getRenderChunk() const noexcept { return renderChunk; }
@@ -84,32 +173,75 @@ namespace eng {
 
 		// cPos is relative to chunk origin
 		static inline constexpr size_t posToIndex(const glm::ivec3& cPos) {
-			return (cPos.z * LAYER_SIZE) + (cPos.y * WIDTH) + cPos.x;
-			//return ((cPos.z & (WIDTH - 1)) << (LOG2_WIDTH * 2)) | ((cPos.y & (WIDTH - 1)) << LOG2_WIDTH) | (cPos.x & (WIDTH - 1));
+			return BlockData::posToIndex(cPos);
 		}
 		// (cX, cY, cZ) is relative to chunk origin
 		static inline constexpr size_t posToIndex(const size_t cX, const size_t cY, const size_t cZ) {
-			return (cZ * LAYER_SIZE) + (cY * WIDTH) + cX;
-			//return ((cZ & (WIDTH - 1)) << (LOG2_WIDTH * 2)) | ((cY & (WIDTH - 1)) << LOG2_WIDTH) | (cX & (WIDTH - 1));
+			return BlockData::posToIndex({ cX, cY, cZ });
 		}
 		static inline constexpr glm::ivec3 indexToPos(const size_t index) {
-			//const int z = index / LAYER_SIZE;
-			//const int y = (index - (z * LAYER_SIZE)) / WIDTH;
-			//const int x = index - ((z * LAYER_SIZE) + (y * WIDTH));
-			//const int z = index / LAYER_SIZE;
-			//const int y = (index - (z * LAYER_SIZE)) / WIDTH;
-			//return { x, y, z };
-			//return { index % WIDTH, (index % LAYER_SIZE) / WIDTH, index / LAYER_SIZE };
+			return BlockData::indexToPos(index);
+		}
+
+		// regionPos is the position of the sub-region in units of sub-regions
+		static inline constexpr size_t getRegionIndex(const glm::ivec3& regionPos) {
+			return (((regionPos.z * chunk_regions_per_axis) + regionPos.y) * chunk_regions_per_axis) + regionPos.x;
+		}
+		// returns the position relative to chunk origin of the first block in a sub-region
+		static inline constexpr glm::ivec3 getRegionOrigin(const size_t region) {
 			return {
-				index & (WIDTH - 1),
-				(index >> LOG2_WIDTH) & (WIDTH - 1),
-				(index >> (LOG2_WIDTH * 2)) & (WIDTH - 1),
+				(region % chunk_regions_per_axis) * REGION_WIDTH,
+				((region / chunk_regions_per_axis) % chunk_regions_per_axis) * REGION_WIDTH,
+				(region / (chunk_regions_per_axis * chunk_regions_per_axis)) * REGION_WIDTH,
 			};
 		}
+		// returns the mask of the sub-regions that overlap the box [cMin, cMax]
+		// cMin and cMax are relative to chunk origin and inclusive, and the box is clipped to the chunk
+		static constexpr RegionMask getRegionMask(const glm::ivec3& cMin, const glm::ivec3& cMax) {
+			constexpr int maxPos = static_cast<int>(WIDTH - 1);
+			if ((cMax.x < 0) || (cMax.y < 0) || (cMax.z < 0) || (cMin.x > maxPos) || (cMin.y > maxPos) || (cMin.z > maxPos))
+				return 0;
+			const glm::ivec3 rMin { vmax(cMin.x, 0) >> chunk_log2_region_width, vmax(cMin.y, 0) >> chunk_log2_region_width, vmax(cMin.z, 0) >> chunk_log2_region_width };
+			const glm::ivec3 rMax { vmin(cMax.x, maxPos) >> chunk_log2_region_width, vmin(cMax.y, maxPos) >> chunk_log2_region_width, vmin(cMax.z, maxPos) >> chunk_log2_region_width };
+			RegionMask mask = 0;
+			for (int z = rMin.z; z <= rMax.z; z++)
+				for (int y = rMin.y; y <= rMax.y; y++)
+					for (int x = rMin.x; x <= rMax.x; x++)
+						mask |= RegionMask{1} << getRegionIndex({ x, y, z });
+			return mask;
+		}
 
 	private:
 
-		void generate();
+		inline BlockData& getMutableBlockData() {
+			touch();
+			modified = true;
+			return makeUnique(blockData);
+		}
+		inline FluidData& getMutableFluidData() {
+			touch();
+			modified = true;
+			return makeUnique(fluidData);
+		}
+
+		// marks the chunk's data as accessed, and decompresses it if it's compressed
+		inline void touch() const {
+			accessed = true;
+			if (compressedContents) decompress();
+		}
+		void decompress() const;
+
+		// copies the data if it's shared with a snapshot
+		template<typename T>
+		static T& makeUnique(std::shared_ptr<T>& data) {
+			if (data.use_count() > 1) {
+				data = std::make_shared<T>(*data);
+			} else {
+				// synchronize with the release of the last snapshot by another thread before writing
+				std::atomic_thread_fence(std::memory_order_acquire);
+			}
+			return *data;
+		}
 
 	};
 
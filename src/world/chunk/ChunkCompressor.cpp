@@ -0,0 +1,77 @@
+#include "ChunkCompressor.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace eng {
+
+	ChunkCompressor::ChunkCompressor() : thread(ChunkCompressor::runCompressorThread, this) {}
+
+	ChunkCompressor::~ChunkCompressor() {
+		{
+			std::scoped_lock<std::mutex> lock { mutex };
+			taskQueue.clear();
+			destroyed = true;
+		}
+		condVar.notify_all();
+		if (thread.joinable()) thread.join();
+	}
+
+	bool ChunkCompressor::enqueue(const ChunkCoord& chunkCoord, Chunk::BlockDataSnapshot blockData, Chunk::FluidDataSnapshot fluidData) {
+		{
+			std::scoped_lock<std::mutex> lock { mutex };
+			if (!compressing.insert(chunkCoord).second) return false;
+			taskQueue.push_back({ chunkCoord, std::move(blockData), std::move(fluidData) });
+		}
+		condVar.notify_one();
+		return true;
+	}
+
+	std::vector<ChunkCompressor::Result> ChunkCompressor::takeCompleted() {
+		std::scoped_lock<std::mutex> lock { mutex };
+		std::vector<Result> results = std::move(completed);
+		completed.clear();
+		for (const Result& result : results)
+			compressing.erase(result.chunkCoord);
+		return results;
+	}
+
+	void ChunkCompressor::recordCompression(const Chunk::CompressedContents& contents) noexcept {
+		stats.compressedChunks++;
+		stats.uncompressedSize += contents.getUncompressedSize();
+		stats.compressedSize += contents.getCompressedSize();
+	}
+
+	void ChunkCompressor::recordDecompression(const Chunk::CompressedContents& contents, const duration decompressionTime) noexcept {
+		recordRelease(contents);
+		stats.decompressions++;
+		stats.totalDecompressionTime += decompressionTime;
+		stats.maxDecompressionTime = std::max(stats.maxDecompressionTime, decompressionTime);
+	}
+
+	void ChunkCompressor::recordRelease(const Chunk::CompressedContents& contents) noexcept {
+		stats.compressedChunks--;
+		stats.uncompressedSize -= contents.getUncompressedSize();
+		stats.compressedSize -= contents.getCompressedSize();
+	}
+
+	void ChunkCompressor::runCompressorThread(ChunkCompressor* const compressor) {
+		std::unique_lock<std::mutex> lock { compressor->mutex };
+		while (true) {
+			compressor->condVar.wait(lock, [compressor]() { return compressor->destroyed || !compressor->taskQueue.empty(); });
+			if (compressor->destroyed) break;
+			Task task = std::move(compressor->taskQueue.front());
+			compressor->taskQueue.pop_front();
+			lock.unlock();
+
+			auto contents = std::make_unique<Chunk::CompressedContents>(Chunk::CompressedContents {
+				CompressedChunkData<Chunk::BlockData>(*task.blockData),
+				CompressedChunkData<Chunk::FluidData>(*task.fluidData),
+			});
+
+			lock.lock();
+			compressor->completed.push_back({ task.chunkCoord, std::move(task.blockData), std::move(task.fluidData), std::move(contents) });
+		}
+	}
+
+}
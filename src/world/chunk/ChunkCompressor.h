@@ -0,0 +1,94 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+#include <deque>
+#include <unordered_set>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <chrono>
+
+#include "Chunk.h"
+#include "ChunkCoord.h"
+
+namespace eng {
+
+	/*
+	 * Compresses the data of chunks that haven't been accessed for a while on a background thread.
+	 * Tasks only hold snapshots of the chunks' data, so a chunk can keep being used (and modified) while it's being compressed.
+	 * The world only swaps the compressed data into a chunk if the chunk's data is still the data in the result's snapshots,
+	 * and the chunk is decompressed on the main thread the next time its data is accessed.
+	 */
+	class ChunkCompressor {
+	public:
+		using duration = std::chrono::steady_clock::duration;
+
+		struct Result {
+			ChunkCoord chunkCoord;
+			// the data that was compressed, which can't be modified in place while the result holds it
+			Chunk::BlockDataSnapshot blockData;
+			Chunk::FluidDataSnapshot fluidData;
+			std::unique_ptr<Chunk::CompressedContents> contents;
+		};
+
+		struct Stats {
+			size_t compressedChunks = 0; // chunks that are currently compressed
+			size_t uncompressedSize = 0; // bytes of packed data in the compressed chunks before compression
+			size_t compressedSize = 0; // bytes of packed data in the compressed chunks after compression
+			size_t decompressions = 0;
+			duration totalDecompressionTime {};
+			duration maxDecompressionTime {};
+
+			inline double getCompressionRatio() const noexcept {
+				return (compressedSize > 0) ? (static_cast<double>(uncompressedSize) / static_cast<double>(compressedSize)) : 1.0;
+			}
+			inline duration getAverageDecompressionTime() const noexcept {
+				return (decompressions > 0) ? (totalDecompressionTime / decompressions) : duration {};
+			}
+		};
+
+	private:
+		struct Task {
+			ChunkCoord chunkCoord;
+			Chunk::BlockDataSnapshot blockData;
+			Chunk::FluidDataSnapshot fluidData;
+		};
+
+		std::mutex mutex;
+		std::condition_variable condVar;
+		bool destroyed = false;
+		std::deque<Task> taskQueue;
+		std::unordered_set<ChunkCoord> compressing; // queued, running, and completed tasks that haven't been taken yet
+		std::vector<Result> completed;
+		std::thread thread;
+
+		Stats stats; // only used on the main thread
+
+	public:
+		ChunkCompressor();
+
+		ChunkCompressor(const ChunkCompressor&) = delete;
+		ChunkCompressor& operator =(const ChunkCompressor&) = delete;
+
+		~ChunkCompressor();
+
+		// returns false if the chunk is already being compressed
+		bool enqueue(const ChunkCoord& chunkCoord, Chunk::BlockDataSnapshot blockData, Chunk::FluidDataSnapshot fluidData);
+
+		// removes every completed task
+		std::vector<Result> takeCompleted();
+
+		inline const Stats& getStats() const noexcept { return stats; }
+		// called when compressed contents are swapped into a chunk
+		void recordCompression(const Chunk::CompressedContents& contents) noexcept;
+		// called when a chunk is decompressed
+		void recordDecompression(const Chunk::CompressedContents& contents, duration decompressionTime) noexcept;
+		// called when a compressed chunk is unloaded
+		void recordRelease(const Chunk::CompressedContents& contents) noexcept;
+
+	private:
+		static void runCompressorThread(ChunkCompressor* const compressor);
+	};
+
+}
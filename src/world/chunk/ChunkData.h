@@ -4,6 +4,7 @@
 #include <utility>
 #include <algorithm>
 #include <cstring>
+#include <cstdint>
 #include <type_traits>
 
 #include <glm/vec3.hpp>
@@ -15,16 +16,49 @@ namespace eng {
 
 	class Chunk;
 
-	enum class ChunkDataOrder { ZYX, YZX };
+	// the order in which the elements of a ChunkData are stored
+	// ZYX and YZX are row-major orders (x varies fastest)
+	// Morton interleaves the bits of x, y, and z (Z-order curve), so that nearby positions along every axis are usually nearby in memory
+	// Brick4 stores the data as 4x4x4 bricks in ZYX order, with the elements of each brick in ZYX order
+	enum class ChunkDataOrder { ZYX, YZX, Morton, Brick4 };
+
+	namespace detail {
+
+		// spreads the low 10 bits of v so that there are 2 zero bits between each of them
+		inline constexpr uint32_t mortonSpread3(uint32_t v) noexcept {
+			v &= 0x000003FF;
+			v = (v | (v << 16)) & 0x030000FF;
+			v = (v | (v << 8)) & 0x0300F00F;
+			v = (v | (v << 4)) & 0x030C30C3;
+			v = (v | (v << 2)) & 0x09249249;
+			return v;
+		}
+		// inverse of mortonSpread3
+		inline constexpr uint32_t mortonCompact3(uint32_t v) noexcept {
+			v &= 0x09249249;
+			v = (v | (v >> 2)) & 0x030C30C3;
+			v = (v | (v >> 4)) & 0x0300F00F;
+			v = (v | (v >> 8)) & 0x030000FF;
+			v = (v | (v >> 16)) & 0x000003FF;
+			return v;
+		}
+
+	}
 
 	template<typename StateType, size_t S, ChunkDataOrder Order = ChunkDataOrder::ZYX>
 	class ChunkData {
+		static_assert((Order != ChunkDataOrder::Morton) || (is_pow2(S) && (S <= 1024)), "Morton order requires a power of 2 width of at most 1024");
+		static_assert((Order != ChunkDataOrder::Brick4) || ((S % 4) == 0), "Brick4 order requires a width that is a multiple of 4");
 	public:
 		using value_type = StateType;
 
 		static constexpr size_t width = S;
 		static constexpr size_t layer_size = S * S;
 		static constexpr size_t volume = S * S * S;
+	private:
+		static constexpr size_t brick_volume = 4 * 4 * 4;
+		static constexpr size_t bricks_per_axis = S / 4;
+	public:
 
 		using iterator = typename std::array<StateType, volume>::iterator;
 		using const_iterator = typename std::array<StateType, volume>::const_iterator;
@@ -72,46 +106,83 @@ namespace eng {
 
 		static inline constexpr ChunkDataOrder getDataOrder() noexcept { return Order; }
 
+		// p is relative to the data origin
+		static inline constexpr size_t posToIndex(const glm::ivec3& p) noexcept {
+			if constexpr (Order == ChunkDataOrder::ZYX) {
+				return (p.z * layer_size) + (p.y * width) + p.x;
+			} else if constexpr (Order == ChunkDataOrder::YZX) {
+				return (p.y * layer_size) + (p.z * width) + p.x;
+			} else if constexpr (Order == ChunkDataOrder::Morton) {
+				return detail::mortonSpread3(static_cast<uint32_t>(p.x)) |
+					(detail::mortonSpread3(static_cast<uint32_t>(p.y)) << 1) |
+					(detail::mortonSpread3(static_cast<uint32_t>(p.z)) << 2);
+			} else if constexpr (Order == ChunkDataOrder::Brick4) {
+				const size_t brick = (((p.z >> 2) * bricks_per_axis) + (p.y >> 2)) * bricks_per_axis + (p.x >> 2);
+				return (brick * brick_volume) | ((p.z & 3) << 4) | ((p.y & 3) << 2) | (p.x & 3);
+			}
+		}
+		// returns the position relative to the data origin of the element at index i
+		static inline constexpr glm::ivec3 indexToPos(const size_t i) noexcept {
+			if constexpr (Order == ChunkDataOrder::ZYX) {
+				return { i % width, (i / width) % width, i / layer_size };
+			} else if constexpr (Order == ChunkDataOrder::YZX) {
+				return { i % width, i / layer_size, (i / width) % width };
+			} else if constexpr (Order == ChunkDataOrder::Morton) {
+				const auto m = static_cast<uint32_t>(i);
+				return { detail::mortonCompact3(m), detail::mortonCompact3(m >> 1), detail::mortonCompact3(m >> 2) };
+			} else if constexpr (Order == ChunkDataOrder::Brick4) {
+				const size_t brick = i / brick_volume;
+				return {
+					((brick % bricks_per_axis) << 2) | (i & 3),
+					(((brick / bricks_per_axis) % bricks_per_axis) << 2) | ((i >> 2) & 3),
+					((brick / (bricks_per_axis * bricks_per_axis)) << 2) | ((i >> 4) & 3),
+				};
+			}
+		}
+
+		// calls func(index, pos) for every element, in storage order
+		// cheaper than calling indexToPos for every index
+		template<typename Func>
+		static inline constexpr void forEachPos(Func&& func) {
+			if constexpr (Order == ChunkDataOrder::ZYX) {
+				size_t i = 0;
+				for (int z = 0; z < static_cast<int>(width); z++)
+					for (int y = 0; y < static_cast<int>(width); y++)
+						for (int x = 0; x < static_cast<int>(width); x++)
+							func(i++, glm::ivec3 { x, y, z });
+			} else if constexpr (Order == ChunkDataOrder::YZX) {
+				size_t i = 0;
+				for (int y = 0; y < static_cast<int>(width); y++)
+					for (int z = 0; z < static_cast<int>(width); z++)
+						for (int x = 0; x < static_cast<int>(width); x++)
+							func(i++, glm::ivec3 { x, y, z });
+			} else if constexpr (Order == ChunkDataOrder::Morton) {
+				for (size_t i = 0; i < volume; i++)
+					func(i, indexToPos(i));
+			} else if constexpr (Order == ChunkDataOrder::Brick4) {
+				size_t i = 0;
+				for (int bz = 0; bz < static_cast<int>(width); bz += 4)
+					for (int by = 0; by < static_cast<int>(width); by += 4)
+						for (int bx = 0; bx < static_cast<int>(width); bx += 4)
+							for (int z = bz; z < bz + 4; z++)
+								for (int y = by; y < by + 4; y++)
+									for (int x = bx; x < bx + 4; x++)
+										func(i++, glm::ivec3 { x, y, z });
+			}
+		}
+
 		inline constexpr const StateType* data() const noexcept { return states.data(); }
 		inline constexpr StateType* data() noexcept { return states.data(); }
 
 		inline const StateType& operator [](const size_t i) const noexcept { return states[i]; }
 		inline StateType& operator [](const size_t i) noexcept { return states[i]; }
-		inline const StateType& operator [](const glm::ivec3& p) const noexcept {
-			if constexpr (Order == ChunkDataOrder::ZYX)
-				return states[(p.z * layer_size) + (p.y * width) + p.x];
-			else if constexpr (Order == ChunkDataOrder::YZX)
-				return states[(p.y * layer_size) + (p.z * width) + p.x];
-			else
-				static_assert((Order == ChunkDataOrder::ZYX) || (Order == ChunkDataOrder::YZX));
-		}
-		inline StateType& operator [](const glm::ivec3& p) noexcept {
-			if constexpr (Order == ChunkDataOrder::ZYX)
-				return states[(p.z * layer_size) + (p.y * width) + p.x];
-			else if constexpr (Order == ChunkDataOrder::YZX)
-				return states[(p.y * layer_size) + (p.z * width) + p.x];
-			else
-				static_assert((Order == ChunkDataOrder::ZYX) || (Order == ChunkDataOrder::YZX));
-		}
+		inline const StateType& operator [](const glm::ivec3& p) const noexcept { return states[posToIndex(p)]; }
+		inline StateType& operator [](const glm::ivec3& p) noexcept { return states[posToIndex(p)]; }
 
 		inline const StateType& at(const size_t i) const { return states.at(i); }
 		inline StateType& at(const size_t i) { return states.at(i); }
-		inline const StateType& at(const glm::ivec3& p) const {
-			if constexpr (Order == ChunkDataOrder::ZYX)
-				return states.at((p.z * layer_size) + (p.y * width) + p.x);
-			else if constexpr (Order == ChunkDataOrder::YZX)
-				return states.at((p.y * layer_size) + (p.z * width) + p.x);
-			else
-				static_assert((Order == ChunkDataOrder::ZYX) || (Order == ChunkDataOrder::YZX));
-		}
-		inline StateType& at(const glm::ivec3& p) {
-			if constexpr (Order == ChunkDataOrder::ZYX)
-				return states.at((p.z * layer_size) + (p.y * width) + p.x);
-			else if constexpr (Order == ChunkDataOrder::YZX)
-				return states.at((p.y * layer_size) + (p.z * width) + p.x);
-			else
-				static_assert((Order == ChunkDataOrder::ZYX) || (Order == ChunkDataOrder::YZX));
-		}
+		inline const StateType& at(const glm::ivec3& p) const { return states.at(posToIndex(p)); }
+		inline StateType& at(const glm::ivec3& p) { return states.at(posToIndex(p)); }
 
 		inline void fill(const StateType& v) { states.fill(v); }
 
@@ -0,0 +1,223 @@
+#include "ChunkGenerator.h"
+
+#include <algorithm>
+#include <iterator>
+#include <utility>
+
+#include "TerrainGenerator.h"
+#include "util/math/math.h"
+
+namespace eng {
+
+	ChunkGenerator::ChunkGenerator(const TerrainGenerator& terrain, size_t threadCount) : terrain(terrain) {
+		if (threadCount == 0) {
+			const auto hardwareThreads = static_cast<int>(std::thread::hardware_concurrency());
+			threadCount = static_cast<size_t>(vmax(hardwareThreads - 4, 1)); // leave a thread for the main thread and each of the 3 chunk baker threads
+		}
+		queueCapacity = threadCount * 4;
+		for (size_t i = 0; i < threadCount; i++)
+			threads.emplace_back(ChunkGenerator::runGeneratorThread, this);
+	}
+
+	ChunkGenerator::~ChunkGenerator() {
+		{
+			std::scoped_lock<std::mutex> lock { mutex };
+			readyQueue.clear();
+			destroyed = true;
+		}
+		condVar.notify_all();
+		for (auto& thread : threads) {
+			if (thread.joinable()) thread.join();
+		}
+	}
+
+	bool ChunkGenerator::enqueue(const ChunkCoord& chunkCoord) {
+		{
+			std::scoped_lock<std::mutex> lock { mutex };
+			if (generating.contains(chunkCoord)) return false;
+			if (const auto it = tasks.find(chunkCoord); (it != tasks.end()) && it->second.protoChunk.isComplete()) {
+				// the contents were already taken, so the chunk has to be generated again once its neighbors are done reading it
+				if (hasDependents(chunkCoord)) return false;
+				tasks.erase(it);
+			}
+			generating.insert(chunkCoord);
+			tasks.try_emplace(chunkCoord, chunkCoord).first->second.enqueued = true;
+			require(chunkCoord, generation_stage::count);
+		}
+		condVar.notify_all();
+		return true;
+	}
+
+	bool ChunkGenerator::isGenerating(const ChunkCoord& chunkCoord) const {
+		std::scoped_lock<std::mutex> lock { mutex };
+		return generating.contains(chunkCoord);
+	}
+
+	size_t ChunkGenerator::queuedTasks() const {
+		std::scoped_lock<std::mutex> lock { mutex };
+		return generating.size() - completed.size();
+	}
+
+	size_t ChunkGenerator::getProtoChunkCount() const {
+		std::scoped_lock<std::mutex> lock { mutex };
+		return tasks.size();
+	}
+
+	ChunkGenerator::StageStatsArray ChunkGenerator::getStageStats() const {
+		std::scoped_lock<std::mutex> lock { mutex };
+		return stageStats;
+	}
+
+	std::vector<ChunkGenerator::Result> ChunkGenerator::takeCompleted(const size_t maxCount) {
+		std::scoped_lock<std::mutex> lock { mutex };
+		const size_t count = std::min(maxCount, completed.size());
+		std::vector<Result> results;
+		results.reserve(count);
+		std::move(completed.begin(), completed.begin() + count, std::back_inserter(results));
+		completed.erase(completed.begin(), completed.begin() + count);
+		for (const Result& result : results)
+			generating.erase(result.chunkCoord);
+		return results;
+	}
+
+	void ChunkGenerator::require(const ChunkCoord& chunkCoord, const size_t stageCount) {
+		Task& task = tasks.try_emplace(chunkCoord, chunkCoord).first->second;
+		if (task.targetStages >= stageCount) return;
+		const size_t firstNewStage = std::max(task.targetStages, task.protoChunk.getCompletedStages());
+		task.targetStages = stageCount;
+		for (size_t s = firstNewStage; s < stageCount; s++) {
+			const int radius = generation_stage::getNeighborRadius(generation_stage::stages[s]);
+			if (radius == 0) continue;
+			ProtoChunk::forEachNeighborOffset(radius, [&](const glm::ivec3& offset) {
+				if (offset != glm::ivec3(0)) require(ChunkCoord(chunkCoord + offset), s);
+			});
+		}
+		scheduleIfReady(chunkCoord);
+	}
+
+	void ChunkGenerator::scheduleIfReady(const ChunkCoord& chunkCoord) {
+		const auto it = tasks.find(chunkCoord);
+		if ((it == tasks.end()) || it->second.ready || !isReady(it->second)) return;
+		it->second.ready = true;
+		readyQueue.push_back(chunkCoord);
+	}
+
+	bool ChunkGenerator::isReady(const Task& task) const {
+		if (task.running || !task.hasPendingStages()) return false;
+		const ProtoChunk& protoChunk = task.protoChunk;
+		const size_t stageIndex = protoChunk.getCompletedStages();
+		bool ready = true;
+		ProtoChunk::forEachNeighborOffset(generation_stage::getNeighborRadius(protoChunk.getNextStage()), [&](const glm::ivec3& offset) {
+			if (!ready || (offset == glm::ivec3(0))) return;
+			const auto it = tasks.find(ChunkCoord(protoChunk.getChunkCoord() + offset));
+			ready = (it != tasks.end()) && (it->second.protoChunk.getCompletedStages() >= stageIndex);
+		});
+		return ready;
+	}
+
+	size_t ChunkGenerator::getDependentStages(const ChunkCoord& chunkCoord) const {
+		size_t dependentStages = 0;
+		ProtoChunk::forEachNeighborOffset(generation_stage::max_neighbor_radius, [&](const glm::ivec3& offset) {
+			if (offset == glm::ivec3(0)) return;
+			const auto it = tasks.find(ChunkCoord(chunkCoord + offset));
+			if (it == tasks.end()) return;
+			const Task& neighbor = it->second;
+			const int distance = ProtoChunk::getNeighborDistance(chunkCoord, neighbor.protoChunk.getChunkCoord());
+			// the stages the neighbor hasn't completed yet (including a running stage) that read the chunk
+			for (size_t s = neighbor.protoChunk.getCompletedStages(); s < neighbor.targetStages; s++) {
+				if (generation_stage::getNeighborRadius(generation_stage::stages[s]) >= distance)
+					dependentStages = std::max(dependentStages, s);
+			}
+		});
+		return dependentStages;
+	}
+
+	bool ChunkGenerator::hasDependents(const ChunkCoord& chunkCoord) const {
+		bool dependents = false;
+		ProtoChunk::forEachNeighborOffset(generation_stage::max_neighbor_radius, [&](const glm::ivec3& offset) {
+			if (dependents || (offset == glm::ivec3(0))) return;
+			const auto it = tasks.find(ChunkCoord(chunkCoord + offset));
+			if (it == tasks.end()) return;
+			const Task& neighbor = it->second;
+			const int distance = ProtoChunk::getNeighborDistance(chunkCoord, neighbor.protoChunk.getChunkCoord());
+			for (size_t s = neighbor.protoChunk.getCompletedStages(); s < neighbor.targetStages; s++)
+				dependents |= generation_stage::getNeighborRadius(generation_stage::stages[s]) >= distance;
+		});
+		return dependents;
+	}
+
+	void ChunkGenerator::release(const ChunkCoord& chunkCoord) {
+		const auto it = tasks.find(chunkCoord);
+		if (it == tasks.end()) return;
+		Task& task = it->second;
+		if (task.enqueued && !task.protoChunk.isComplete()) return;
+		if (!task.enqueued) task.targetStages = getDependentStages(chunkCoord);
+		if (task.running || task.hasPendingStages() || hasDependents(chunkCoord)) return;
+		tasks.erase(it); // its entry in readyQueue (if any) is skipped
+		releaseCompleteNeighbors(chunkCoord);
+	}
+
+	void ChunkGenerator::releaseCompleteNeighbors(const ChunkCoord& chunkCoord) {
+		// a complete chunk is kept while a chunk around it is incomplete, in case that chunk ends up reading it
+		const auto isReleasable = [this](const ChunkCoord& coord) {
+			const auto it = tasks.find(coord);
+			if ((it == tasks.end()) || it->second.running || !it->second.protoChunk.isComplete()) return false;
+			bool releasable = true;
+			ProtoChunk::forEachNeighborOffset(generation_stage::max_neighbor_radius, [&](const glm::ivec3& offset) {
+				if (!releasable) return;
+				const auto neighbor = tasks.find(ChunkCoord(coord + offset));
+				releasable = (neighbor == tasks.end()) || neighbor->second.protoChunk.isComplete();
+			});
+			return releasable;
+		};
+		ProtoChunk::forEachNeighborOffset(generation_stage::max_neighbor_radius, [&](const glm::ivec3& offset) {
+			const ChunkCoord coord { chunkCoord + offset };
+			if (isReleasable(coord)) tasks.erase(coord);
+		});
+	}
+
+	void ChunkGenerator::runGeneratorThread(ChunkGenerator* const generator) {
+		std::unique_lock<std::mutex> lock { generator->mutex };
+		while (true) {
+			generator->condVar.wait(lock, [generator]() { return generator->destroyed || !generator->readyQueue.empty(); });
+			if (generator->destroyed) break;
+			const ChunkCoord chunkCoord = generator->readyQueue.front();
+			generator->readyQueue.pop_front();
+			const auto it = generator->tasks.find(chunkCoord);
+			if ((it == generator->tasks.end()) || !it->second.ready) continue; // the task was released after it was queued
+			Task& task = it->second;
+			task.ready = false;
+			if (!generator->isReady(task)) continue; // rescheduled when its neighbors catch up
+			task.running = true;
+			// the neighbors can't be released while a running stage reads them
+			ProtoChunk::Neighborhood neighbors {};
+			ProtoChunk::forEachNeighborOffset(generation_stage::getNeighborRadius(task.protoChunk.getNextStage()), [&](const glm::ivec3& offset) {
+				neighbors[ProtoChunk::getNeighborIndex(offset)] = &generator->tasks.at(ChunkCoord(chunkCoord + offset)).protoChunk;
+			});
+			const size_t stageIndex = task.protoChunk.getCompletedStages();
+			lock.unlock();
+
+			const auto stageStartTime = std::chrono::steady_clock::now();
+			task.protoChunk.runNextStage(generator->terrain, neighbors);
+			const auto stageTime = std::chrono::steady_clock::now() - stageStartTime;
+
+			lock.lock();
+			task.protoChunk.completeStage();
+			task.running = false;
+			generator->stageStats[stageIndex].runs++;
+			generator->stageStats[stageIndex].time += std::chrono::duration_cast<std::chrono::nanoseconds>(stageTime);
+			if (task.protoChunk.isComplete() && task.enqueued)
+				generator->completed.push_back({ chunkCoord, task.protoChunk.takeContents() });
+			// the chunk's next stage, and the stages of the chunks around it that were waiting for it, may be able to run now
+			bool scheduled = false;
+			ProtoChunk::forEachNeighborOffset(generation_stage::max_neighbor_radius, [&](const glm::ivec3& offset) {
+				const size_t queueSize = generator->readyQueue.size();
+				generator->scheduleIfReady(ChunkCoord(chunkCoord + offset));
+				scheduled |= generator->readyQueue.size() > queueSize;
+			});
+			generator->releaseCompleteNeighbors(chunkCoord);
+			if (scheduled) generator->condVar.notify_all();
+		}
+	}
+
+}
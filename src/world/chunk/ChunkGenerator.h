@@ -0,0 +1,136 @@
+#pragma once
+
+#include <array>
+#include <vector>
+#include <deque>
+#include <unordered_map>
+#include <unordered_set>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <condition_variable>
+#include <chrono>
+#include <cstdint>
+
+#include "Chunk.h"
+#include "ChunkCoord.h"
+#include "ProtoChunk.h"
+
+namespace eng {
+
+	class TerrainGenerator;
+
+	/*
+	 * Generates the contents of chunks on a pool of worker threads.
+	 * A chunk is "generating" from when it's enqueued until its contents are taken with takeCompleted(), and the main thread creates the Chunk itself
+	 * (creating a RenderChunk needs the OpenGL context).
+	 * Chunks are generated in stages (see GenerationStage), and each stage of a chunk runs as a separate task as soon as the chunks within the stage's
+	 * neighbor radius have finished the stages before it. Enqueueing a chunk also generates the stages of its neighbors that it depends on.
+	 * The partially generated chunks are kept here, outside of the world's loaded chunks, until no enqueued chunk depends on them.
+	 * Generation only depends on the terrain generator and the chunk coordinate, so the results don't depend on the number of threads or the order tasks finish in.
+	 */
+	class ChunkGenerator {
+	public:
+		struct Result {
+			ChunkCoord chunkCoord;
+			Chunk::Contents contents;
+		};
+		// the number of times a stage ran on the generator threads, and the total time they spent running it
+		struct StageStats {
+			uint64_t runs = 0;
+			std::chrono::nanoseconds time {};
+		};
+		using StageStatsArray = std::array<StageStats, generation_stage::count>; // indexed by generation_stage::getIndex
+
+	private:
+		struct Task {
+			ProtoChunk protoChunk;
+			size_t targetStages = 0; // the number of stages to run: every stage for enqueued chunks, and the stages that neighbors depend on otherwise
+			bool enqueued = false; // whether the chunk itself was enqueued, or is only generated for its neighbors
+			bool running = false;
+			bool ready = false; // whether the chunk is in readyQueue
+
+			explicit Task(const ChunkCoord& chunkCoord) : protoChunk(chunkCoord) {}
+
+			inline bool hasPendingStages() const noexcept { return protoChunk.getCompletedStages() < targetStages; }
+		};
+
+		const TerrainGenerator& terrain;
+
+		mutable std::mutex mutex;
+		std::condition_variable condVar;
+		std::atomic_bool destroyed { false };
+		std::unordered_map<ChunkCoord, Task> tasks; // the chunks that are partially generated, and the complete chunks that neighbors may still read
+		std::deque<ChunkCoord> readyQueue; // chunks whose next stage can run, in FIFO order
+		std::unordered_set<ChunkCoord> generating; // enqueued chunks that haven't been taken yet
+		std::vector<Result> completed;
+		StageStatsArray stageStats {};
+		std::vector<std::thread> threads;
+		size_t queueCapacity;
+
+	public:
+		// threadCount = 0 uses every hardware thread that isn't used by the main thread or the chunk bakery
+		explicit ChunkGenerator(const TerrainGenerator& terrain, size_t threadCount = 0);
+
+		ChunkGenerator(const ChunkGenerator&) = delete;
+		ChunkGenerator& operator =(const ChunkGenerator&) = delete;
+
+		~ChunkGenerator();
+
+		inline size_t getThreadCount() const noexcept { return threads.size(); }
+		// the number of chunks that should be enqueued at once, to keep every thread busy without generating too far ahead
+		inline size_t getQueueCapacity() const noexcept { return queueCapacity; }
+
+		// a chunk that was partially generated as a neighbor of another chunk continues from the stages it completed
+		// returns false if the chunk is already generating, or if it was already generated and the chunks around it still read it
+		// (it can be enqueued again once they're done)
+		bool enqueue(const ChunkCoord& chunkCoord);
+		bool isGenerating(const ChunkCoord& chunkCoord) const;
+		// the number of enqueued chunks that haven't completed, not counting completed chunks
+		size_t queuedTasks() const;
+		// the number of partially generated chunks, including the neighbors of enqueued chunks
+		size_t getProtoChunkCount() const;
+		StageStatsArray getStageStats() const;
+
+		// stops generating the chunks for which shouldCancel(chunkCoord) returns true, unless an enqueued chunk still depends on them,
+		// and drops the stages they completed
+		template<typename F>
+		void cancelQueued(F&& shouldCancel) {
+			std::scoped_lock<std::mutex> lock { mutex };
+			std::vector<ChunkCoord> cancelled;
+			for (const auto& [chunkCoord, task] : tasks) {
+				if (shouldCancel(chunkCoord)) cancelled.push_back(chunkCoord);
+			}
+			for (const ChunkCoord& chunkCoord : cancelled) {
+				Task& task = tasks.at(chunkCoord);
+				if (task.enqueued && !task.protoChunk.isComplete()) {
+					task.enqueued = false;
+					generating.erase(chunkCoord);
+				}
+			}
+			for (const ChunkCoord& chunkCoord : cancelled)
+				release(chunkCoord);
+		}
+
+		// removes up to maxCount completed chunks, in the order they were completed
+		std::vector<Result> takeCompleted(size_t maxCount);
+
+	private:
+		// makes the chunk run at least stageCount stages, along with the stages of its neighbors that those stages depend on
+		void require(const ChunkCoord& chunkCoord, size_t stageCount);
+		// adds the chunk to the ready queue if its next stage can run
+		void scheduleIfReady(const ChunkCoord& chunkCoord);
+		bool isReady(const Task& task) const;
+		// the number of stages that the chunks around chunkCoord still need it to complete
+		size_t getDependentStages(const ChunkCoord& chunkCoord) const;
+		// whether a chunk around chunkCoord has a stage left that reads it
+		bool hasDependents(const ChunkCoord& chunkCoord) const;
+		// lowers the target of a chunk that isn't enqueued to the stages its neighbors need, and removes it if nothing reads it anymore
+		void release(const ChunkCoord& chunkCoord);
+		// removes the complete chunks around chunkCoord that no chunk can read anymore
+		void releaseCompleteNeighbors(const ChunkCoord& chunkCoord);
+
+		static void runGeneratorThread(ChunkGenerator* const generator);
+	};
+
+}
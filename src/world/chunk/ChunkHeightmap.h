@@ -0,0 +1,115 @@
+#pragma once
+
+#include <array>
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+
+#include <glm/vec3.hpp>
+
+#include "chunk_consts.h"
+
+namespace eng {
+
+	/*
+	 * The height of the topmost non-empty block in each column of a chunk, relative to the chunk's origin.
+	 * Columns that only contain empty blocks have a height of empty_column.
+	 * The heightmap is kept separately from the chunk's block data, so it can be read without decompressing the chunk.
+	 */
+	class ChunkHeightmap {
+	public:
+		using height_t = int8_t;
+		static constexpr height_t empty_column = -1;
+		static constexpr size_t width = chunk_width;
+		static_assert(width <= 128, "Chunk is too tall for ChunkHeightmap::height_t");
+
+	private:
+		std::array<height_t, width * width> heights;
+		height_t maxHeight = empty_column; // the highest column in the chunk
+
+	public:
+		ChunkHeightmap() noexcept {
+			heights.fill(empty_column);
+		}
+		template<typename Data>
+		explicit ChunkHeightmap(const Data& blockData) {
+			compute(blockData);
+		}
+
+		// x and z are relative to the chunk's origin
+		inline int get(const int x, const int z) const noexcept { return heights[getIndex(x, z)]; }
+		inline int getMaxHeight() const noexcept { return maxHeight; }
+		// whether every block in the chunk is empty
+		inline bool isEmpty() const noexcept { return maxHeight == empty_column; }
+		// whether every block above cPos.y in the column of cPos is empty
+		inline bool isEmptyAbove(const glm::ivec3& cPos) const noexcept { return get(cPos.x, cPos.z) <= cPos.y; }
+
+		template<typename Data>
+		void compute(const Data& blockData) {
+			if (blockData.isUniform()) {
+				heights.fill(blockData.getUniformState().isEmpty() ? empty_column : static_cast<height_t>(width - 1));
+				maxHeight = heights[0];
+				return;
+			}
+			// check each palette entry once instead of each block
+			const auto& palette = blockData.getPalette();
+			std::vector<bool> emptyEntries(palette.size());
+			for (size_t p = 0; p < palette.size(); p++)
+				emptyEntries[p] = palette[p].isEmpty();
+			for (int z = 0; z < static_cast<int>(width); z++) {
+				for (int x = 0; x < static_cast<int>(width); x++) {
+					int y = static_cast<int>(width) - 1;
+					while ((y >= 0) && emptyEntries[blockData.getPaletteIndex(Data::posToIndex({ x, y, z }))]) y--;
+					heights[getIndex(x, z)] = static_cast<height_t>(y);
+				}
+			}
+			maxHeight = *std::max_element(heights.begin(), heights.end());
+		}
+
+		// updates the column of a block that was just set
+		template<typename Data>
+		void onBlockChanged(const Data& blockData, const glm::ivec3& cPos, const bool empty) {
+			height_t& height = heights[getIndex(cPos.x, cPos.z)];
+			if (!empty) {
+				if (cPos.y > height) {
+					height = static_cast<height_t>(cPos.y);
+					maxHeight = std::max(maxHeight, height);
+				}
+			} else if (cPos.y == height) {
+				updateColumn(blockData, cPos.x, cPos.z, cPos.y - 1);
+			}
+		}
+
+		// updates the columns of the blocks in the box [cMin, cMax], which were just changed
+		template<typename Data>
+		void onBoxChanged(const Data& blockData, const glm::ivec3& cMin, const glm::ivec3& cMax) {
+			for (int z = cMin.z; z <= cMax.z; z++) {
+				for (int x = cMin.x; x <= cMax.x; x++) {
+					// the blocks above the box didn't change
+					if (get(x, z) <= cMax.y) updateColumn(blockData, x, z, cMax.y);
+				}
+			}
+		}
+
+	private:
+		static inline constexpr size_t getIndex(const int x, const int z) noexcept {
+			return (static_cast<size_t>(z) * width) + static_cast<size_t>(x);
+		}
+
+		// scans the column down from topY, where every block above topY is known to be empty
+		template<typename Data>
+		void updateColumn(const Data& blockData, const int x, const int z, const int topY) {
+			int y = topY;
+			while ((y >= 0) && blockData.get(Data::posToIndex({ x, y, z })).isEmpty()) y--;
+			height_t& height = heights[getIndex(x, z)];
+			const height_t prevHeight = height;
+			height = static_cast<height_t>(y);
+			if (height > maxHeight)
+				maxHeight = height;
+			else if ((prevHeight == maxHeight) && (height < prevHeight))
+				maxHeight = *std::max_element(heights.begin(), heights.end());
+		}
+	};
+
+}
@@ -0,0 +1,160 @@
+#pragma once
+
+#include <vector>
+#include <unordered_map>
+#include <utility>
+#include <cstddef>
+#include <cstdint>
+
+#include "ChunkCoord.h"
+
+namespace eng {
+
+	class Chunk;
+
+	/*
+	 * Maps chunk coordinates to the loaded chunks around the player.
+	 * Chunks are stored in a toroidal grid, in the slot given by their coordinate modulo the grid's width, so looking up a chunk is a
+	 * few bit operations and a comparison instead of a hash map lookup. Loaded chunks always form a sphere around the player that fits
+	 * in the grid, so as the player moves, the slots of unloaded chunks behind the player are reused by the chunks loaded in front of them.
+	 * Chunks whose slot is taken by another chunk (e.g. while both old and new chunks are loaded after a teleport) are stored in a hash map.
+	 */
+	class ChunkIndex {
+	public:
+		using value_type = std::pair<ChunkCoord, Chunk*>;
+		using const_iterator = std::vector<value_type>::const_iterator;
+
+	private:
+		struct Slot {
+			ChunkCoord chunkCoord;
+			Chunk* chunk = nullptr;
+			uint32_t listIndex = 0; // index of the chunk in chunkList
+		};
+		struct FallbackEntry {
+			Chunk* chunk = nullptr;
+			uint32_t listIndex = 0;
+		};
+
+		int log2Width = 0;
+		int widthMask = 0;
+		std::vector<Slot> slots;
+		std::unordered_map<ChunkCoord, FallbackEntry> fallback; // chunks whose slot was taken when they were added
+		std::vector<value_type> chunkList; // every chunk in the index, for iteration
+
+	public:
+		// chunkRadius is the largest distance in chunks (on any axis) between loaded chunks and the center of the loaded area
+		explicit ChunkIndex(const int chunkRadius = 0) {
+			setRadius(chunkRadius);
+		}
+
+		ChunkIndex(const ChunkIndex&) = delete;
+		ChunkIndex& operator =(const ChunkIndex&) = delete;
+
+		inline size_t size() const noexcept { return chunkList.size(); }
+		inline bool empty() const noexcept { return chunkList.empty(); }
+		// the number of chunks that didn't fit in the grid
+		inline size_t fallbackSize() const noexcept { return fallback.size(); }
+		inline int getWidth() const noexcept { return 1 << log2Width; }
+
+		inline const_iterator begin() const noexcept { return chunkList.begin(); }
+		inline const_iterator end() const noexcept { return chunkList.end(); }
+
+		// returns nullptr if the chunk isn't in the index
+		inline Chunk* find(const ChunkCoord& chunkCoord) const {
+			const Slot& slot = slots[getSlotIndex(chunkCoord)];
+			if ((slot.chunkCoord == chunkCoord) && slot.chunk) return slot.chunk;
+			if (fallback.empty()) return nullptr;
+			const auto it = fallback.find(chunkCoord);
+			return (it == fallback.end()) ? nullptr : it->second.chunk;
+		}
+		inline bool contains(const ChunkCoord& chunkCoord) const { return find(chunkCoord) != nullptr; }
+
+		// returns false if there's already a chunk at chunkCoord
+		bool insert(const ChunkCoord& chunkCoord, Chunk* const chunk) {
+			if (contains(chunkCoord)) return false;
+			const auto listIndex = static_cast<uint32_t>(chunkList.size());
+			chunkList.emplace_back(chunkCoord, chunk);
+			if (Slot& slot = slots[getSlotIndex(chunkCoord)]; !slot.chunk)
+				slot = { chunkCoord, chunk, listIndex };
+			else
+				fallback.emplace(chunkCoord, FallbackEntry { chunk, listIndex });
+			return true;
+		}
+
+		// removes the chunk at chunkCoord, and returns it (or nullptr if there isn't a chunk at chunkCoord)
+		Chunk* erase(const ChunkCoord& chunkCoord) {
+			Chunk* chunk = nullptr;
+			uint32_t listIndex = 0;
+			if (Slot& slot = slots[getSlotIndex(chunkCoord)]; slot.chunk && (slot.chunkCoord == chunkCoord)) {
+				chunk = slot.chunk;
+				listIndex = slot.listIndex;
+				slot.chunk = nullptr;
+				// move a chunk that's waiting for this slot into the grid
+				if (!fallback.empty()) {
+					for (auto it = fallback.begin(); it != fallback.end(); ++it) {
+						if (getSlotIndex(it->first) != getSlotIndex(chunkCoord)) continue;
+						slot = { it->first, it->second.chunk, it->second.listIndex };
+						fallback.erase(it);
+						break;
+					}
+				}
+			} else if (auto it = fallback.find(chunkCoord); it != fallback.end()) {
+				chunk = it->second.chunk;
+				listIndex = it->second.listIndex;
+				fallback.erase(it);
+			} else {
+				return nullptr;
+			}
+
+			// swap the last chunk in the list into the removed chunk's place
+			if (listIndex != (chunkList.size() - 1)) {
+				chunkList[listIndex] = chunkList.back();
+				setListIndex(chunkList[listIndex].first, listIndex);
+			}
+			chunkList.pop_back();
+			return chunk;
+		}
+
+		void clear() {
+			for (auto& slot : slots) slot.chunk = nullptr;
+			fallback.clear();
+			chunkList.clear();
+		}
+
+		// resizes the grid if it's too small for chunkRadius
+		void setRadius(const int chunkRadius) {
+			// loaded chunks can be up to (2 * chunkRadius + 1) chunks apart, and chunks are loaded before the chunks that went out of range
+			// are unloaded, so the grid is one chunk wider on each side
+			const int minWidth = (2 * chunkRadius) + 3;
+			int newLog2Width = 0;
+			while ((1 << newLog2Width) < minWidth) newLog2Width++;
+			if (!slots.empty() && (newLog2Width <= log2Width)) return;
+
+			log2Width = newLog2Width;
+			widthMask = (1 << log2Width) - 1;
+			slots.assign(size_t{1} << (3 * log2Width), Slot {});
+			fallback.clear();
+			const std::vector<value_type> oldChunkList = std::move(chunkList);
+			chunkList.clear();
+			chunkList.reserve(oldChunkList.size());
+			for (const auto& [chunkCoord, chunk] : oldChunkList)
+				insert(chunkCoord, chunk);
+		}
+
+	private:
+		inline size_t getSlotIndex(const ChunkCoord& chunkCoord) const noexcept {
+			// two's complement masking wraps negative coordinates around the grid
+			return static_cast<size_t>(chunkCoord.x & widthMask) |
+				(static_cast<size_t>(chunkCoord.y & widthMask) << log2Width) |
+				(static_cast<size_t>(chunkCoord.z & widthMask) << (2 * log2Width));
+		}
+
+		void setListIndex(const ChunkCoord& chunkCoord, const uint32_t listIndex) {
+			if (Slot& slot = slots[getSlotIndex(chunkCoord)]; slot.chunk && (slot.chunkCoord == chunkCoord))
+				slot.listIndex = listIndex;
+			else
+				fallback.at(chunkCoord).listIndex = listIndex;
+		}
+	};
+
+}
@@ -0,0 +1,48 @@
+#include "ChunkLoadBudget.h"
+
+#include <algorithm>
+
+namespace eng {
+
+	// exponential moving average, with new samples weighted by 1/4
+	static inline ChunkLoadBudget::duration smooth(const ChunkLoadBudget::duration average, const ChunkLoadBudget::duration sample) noexcept {
+		return average + ((sample - average) / 4);
+	}
+
+	void ChunkLoadBudget::reportFrameTime(const duration frameTime) noexcept {
+		// long stalls (e.g. moving the window, or a gui that hides the world) don't say anything about the cost of loading chunks
+		if (frameTime > (targetFrameTime * 16)) return;
+		state.frameTime = hasFrameTime ? smooth(state.frameTime, frameTime) : frameTime;
+		hasFrameTime = true;
+	}
+
+	void ChunkLoadBudget::reportTick(const duration tickTime, const size_t meshingQueueSize, const Limit limitedBy) noexcept {
+		state.tickTime = hasTickTime ? smooth(state.tickTime, tickTime) : tickTime;
+		hasTickTime = true;
+		state.meshingQueueSize = meshingQueueSize;
+
+		// frame times within 10% of the target are counted as on target, to tolerate vsync jitter
+		const bool frameTimeOver = hasFrameTime && ((state.frameTime * 10) > (targetFrameTime * 11));
+		const bool tickTimeOver = state.tickTime > targetTickTime;
+		state.overloaded = frameTimeOver || tickTimeOver;
+		if (state.overloaded) {
+			state.rampingUp = false;
+			state.loadBudget = std::max(state.loadBudget / 2, MIN_LOAD_BUDGET);
+			state.meshingQueueLimit = std::max(state.meshingQueueLimit / 2, MIN_MESHING_QUEUE_LIMIT);
+			return;
+		}
+
+		// only grow while the budgets are being used, and the smoothed tick time leaves room for the extra work
+		if ((limitedBy == Limit::None) || ((state.tickTime * 2) > targetTickTime)) return;
+		if (state.rampingUp) {
+			state.loadBudget = std::min(state.loadBudget * 2, MAX_LOAD_BUDGET);
+			state.meshingQueueLimit = std::min(state.meshingQueueLimit * 2, MAX_MESHING_QUEUE_LIMIT);
+		} else {
+			state.loadBudget = std::min(state.loadBudget + 1, MAX_LOAD_BUDGET);
+			// a bigger meshing queue only helps if the queue is what's limiting loading
+			if (limitedBy == Limit::MeshingQueue)
+				state.meshingQueueLimit = std::min(state.meshingQueueLimit + 2, MAX_MESHING_QUEUE_LIMIT);
+		}
+	}
+
+}
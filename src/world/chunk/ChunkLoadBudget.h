@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstddef>
+#include <chrono>
+
+namespace eng {
+
+	/*
+	 * Feedback controller for the number of chunks added to the world each tick, and the number of meshing tasks that can be queued before
+	 * chunk loading stops.
+	 * The budgets grow multiplicatively while ramping up (after the world is created or the player teleports) and additively otherwise,
+	 * as long as the smoothed frame time and tick time are within their targets. They're halved when either goes over its target.
+	 */
+	class ChunkLoadBudget {
+	public:
+		using duration = std::chrono::nanoseconds;
+
+		// what limited the number of chunks added to the world in a tick
+		enum class Limit {
+			None, // there were fewer chunks ready than the load limit
+			Budget,
+			MeshingQueue,
+		};
+
+		static constexpr size_t MIN_LOAD_BUDGET = 1;
+		static constexpr size_t MAX_LOAD_BUDGET = 128;
+		static constexpr size_t MIN_MESHING_QUEUE_LIMIT = 4;
+		static constexpr size_t MAX_MESHING_QUEUE_LIMIT = 256;
+
+		// the controller's state, for debugging
+		struct State {
+			size_t loadBudget = 8; // maximum number of chunks to add to the world per tick
+			size_t meshingQueueLimit = 8; // chunks aren't added to the world while this many meshing tasks are queued
+			duration tickTime {}; // smoothed duration of World::update
+			duration frameTime {}; // smoothed time between frames
+			size_t meshingQueueSize = 0; // meshing queue size at the start of the last tick
+			bool rampingUp = true;
+			bool overloaded = false; // whether the budgets were reduced in the last tick
+		};
+
+	private:
+		duration targetFrameTime;
+		duration targetTickTime;
+		State state {};
+		bool hasFrameTime = false;
+		bool hasTickTime = false;
+
+	public:
+		// targetTickTime is the time World::update can take without delaying the next frame
+		explicit ChunkLoadBudget(duration targetFrameTime = std::chrono::nanoseconds(1'000'000'000 / 60), duration targetTickTime = std::chrono::milliseconds(8)) :
+				targetFrameTime(targetFrameTime), targetTickTime(targetTickTime) {}
+
+		inline const State& getState() const noexcept { return state; }
+		inline size_t getLoadBudget() const noexcept { return state.loadBudget; }
+		inline size_t getMeshingQueueLimit() const noexcept { return state.meshingQueueLimit; }
+		inline duration getTargetFrameTime() const noexcept { return targetFrameTime; }
+		inline duration getTargetTickTime() const noexcept { return targetTickTime; }
+
+		// the number of chunks that can be added to the world this tick
+		inline size_t getLoadLimit(const size_t meshingQueueSize) const noexcept {
+			if (meshingQueueSize >= state.meshingQueueLimit) return 0;
+			const size_t queueSpace = state.meshingQueueLimit - meshingQueueSize;
+			return (queueSpace < state.loadBudget) ? queueSpace : state.loadBudget;
+		}
+
+		// ramp up again, e.g. after the player teleports into an area that isn't loaded
+		inline void startRampUp() noexcept { state.rampingUp = true; }
+		// called when there's nothing left to load
+		inline void stopRampUp() noexcept { state.rampingUp = false; }
+
+		void reportFrameTime(duration frameTime) noexcept;
+		// updates the budgets after a tick
+		// meshingQueueSize is the number of queued meshing tasks at the start of the tick
+		void reportTick(duration tickTime, size_t meshingQueueSize, Limit limitedBy) noexcept;
+	};
+
+}
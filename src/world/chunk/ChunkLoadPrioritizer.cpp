@@ -0,0 +1,40 @@
+#include "ChunkLoadPrioritizer.h"
+
+#include <algorithm>
+
+#include <glm/geometric.hpp>
+#include <glm/common.hpp>
+
+namespace eng {
+
+	void ChunkLoadPrioritizer::update(const glm::vec3& position, const glm::vec3& velocity, const glm::vec3& lookVec, const float maxPrediction) noexcept {
+		this->position = position;
+		glm::vec3 prediction = velocity * PREDICTION_TICKS;
+		if (const float predictionDist = glm::length(prediction); predictionDist > maxPrediction)
+			prediction *= maxPrediction / predictionDist;
+		predictedPosition = position + prediction;
+		if (const float lookLength = glm::length(lookVec); lookLength > 0.0f)
+			this->lookVec = lookVec / lookLength;
+	}
+
+	float ChunkLoadPrioritizer::getScore(const ChunkCoord& chunkCoord) const noexcept {
+		const glm::vec3 chunkCenter = static_cast<glm::vec3>(ChunkCoord::toBlockPos(chunkCoord)) + (static_cast<float>(Chunk::WIDTH) / 2.0f);
+		const glm::vec3 toChunk = chunkCenter - position;
+		const float chunkDist = glm::length(toChunk);
+		// the chunks around the player are visible no matter which way the camera is facing
+		const float facing = (chunkDist > static_cast<float>(Chunk::WIDTH)) ? glm::dot(toChunk / chunkDist, lookVec) : 1.0f;
+		const float viewWeight = glm::mix(BEHIND_VIEW_WEIGHT, 1.0f, (facing + 1.0f) / 2.0f);
+		return glm::distance(chunkCenter, predictedPosition) * viewWeight;
+	}
+
+	void ChunkLoadPrioritizer::sortCandidates(std::vector<ChunkCoord>& candidates) {
+		scoredCandidates.clear();
+		scoredCandidates.reserve(candidates.size());
+		for (const ChunkCoord& chunkCoord : candidates)
+			scoredCandidates.emplace_back(getScore(chunkCoord), chunkCoord);
+		std::sort(scoredCandidates.begin(), scoredCandidates.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+		for (size_t i = 0; i < candidates.size(); i++)
+			candidates[i] = scoredCandidates[i].second;
+	}
+
+}
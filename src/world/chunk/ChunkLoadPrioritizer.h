@@ -0,0 +1,44 @@
+#pragma once
+
+#include <vector>
+#include <utility>
+
+#include <glm/vec3.hpp>
+
+#include "Chunk.h"
+#include "ChunkCoord.h"
+
+namespace eng {
+
+	/*
+	 * Decides the order that chunks around the player are loaded in.
+	 * Chunks are scored by their distance from the player's predicted position, which is extrapolated from the player's velocity,
+	 * and chunks outside of the camera's view are scored as if they were further away.
+	 * This loads the chunks in front of a moving player first, and the world prefetches the chunks around the predicted position.
+	 */
+	class ChunkLoadPrioritizer {
+	public:
+		static constexpr float PREDICTION_TICKS = 20.0f; // how far ahead the player's position is predicted
+		static constexpr float BEHIND_VIEW_WEIGHT = 2.0f; // distance multiplier for chunks directly behind the camera
+
+	private:
+		glm::vec3 position { 0.0f, 0.0f, 0.0f };
+		glm::vec3 predictedPosition { 0.0f, 0.0f, 0.0f };
+		glm::vec3 lookVec { 0.0f, 0.0f, -1.0f };
+		std::vector<std::pair<float, ChunkCoord>> scoredCandidates; // reused between calls to sortCandidates
+
+	public:
+		// velocity is in blocks per tick, and the predicted position is at most maxPrediction blocks from position
+		void update(const glm::vec3& position, const glm::vec3& velocity, const glm::vec3& lookVec, float maxPrediction) noexcept;
+
+		inline const glm::vec3& getPosition() const noexcept { return position; }
+		inline const glm::vec3& getPredictedPosition() const noexcept { return predictedPosition; }
+
+		// lower scores are loaded first
+		float getScore(const ChunkCoord& chunkCoord) const noexcept;
+
+		// sorts candidates by score
+		void sortCandidates(std::vector<ChunkCoord>& candidates);
+	};
+
+}
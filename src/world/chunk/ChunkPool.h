@@ -0,0 +1,79 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <new>
+#include <utility>
+#include <cstddef>
+#include <cassert>
+
+#include "Chunk.h"
+
+namespace eng {
+
+	/*
+	 * Allocates Chunks from fixed-size slabs, and recycles the storage of destroyed Chunks through a free list.
+	 * Chunks never move once they are created, so pointers to them stay valid until they are destroyed.
+	 */
+	class ChunkPool {
+	public:
+		static constexpr size_t slab_size = 64; // number of chunks per slab
+
+	private:
+		struct alignas(Chunk) ChunkSlot {
+			std::byte storage[sizeof(Chunk)];
+		};
+
+		std::vector<std::unique_ptr<ChunkSlot[]>> slabs;
+		std::vector<ChunkSlot*> freeSlots;
+		size_t liveChunks = 0;
+
+	public:
+		ChunkPool() = default;
+
+		ChunkPool(const ChunkPool&) = delete;
+		ChunkPool(ChunkPool&&) = default;
+		ChunkPool& operator =(const ChunkPool&) = delete;
+		ChunkPool& operator =(ChunkPool&&) = default;
+
+		// all chunks must be destroyed before the pool is destroyed
+		~ChunkPool() {
+			assert(liveChunks == 0);
+		}
+
+		// ensures that at least the given number of chunks can be created without allocating another slab
+		void reserve(const size_t chunks) {
+			while (capacity() < chunks) addSlab();
+		}
+
+		template<typename... Args>
+		[[nodiscard]] Chunk* create(Args&&... args) {
+			if (freeSlots.empty()) addSlab();
+			ChunkSlot* const slot = freeSlots.back();
+			Chunk* const chunk = ::new (static_cast<void*>(slot->storage)) Chunk(std::forward<Args>(args)...);
+			freeSlots.pop_back();
+			liveChunks++;
+			return chunk;
+		}
+
+		void destroy(Chunk* const chunk) {
+			if (!chunk) return;
+			chunk->~Chunk();
+			freeSlots.push_back(reinterpret_cast<ChunkSlot*>(chunk));
+			liveChunks--;
+		}
+
+		inline size_t size() const noexcept { return liveChunks; }
+		inline size_t capacity() const noexcept { return slabs.size() * slab_size; }
+
+	private:
+		void addSlab() {
+			ChunkSlot* const slab = slabs.emplace_back(std::make_unique<ChunkSlot[]>(slab_size)).get();
+			freeSlots.reserve(capacity());
+			for (size_t i = slab_size; i > 0; i--)
+				freeSlots.push_back(slab + (i - 1));
+		}
+
+	};
+
+}
@@ -0,0 +1,228 @@
+#include "ChunkStorage.h"
+
+#include <string>
+#include <utility>
+#include <algorithm>
+#include <stdexcept>
+#include <iostream>
+
+#include <glm/gtx/string_cast.hpp>
+
+#include "block/BlockRegistry.h"
+#include "fluid/FluidRegistry.h"
+#include "util/nbt/NBT.h"
+#include "util/IOUtils.h"
+
+namespace eng {
+
+	static constexpr nbt::nbt_int chunk_data_version = 1;
+
+	ChunkStorage::ChunkStorage(std::filesystem::path directory) : directory(std::move(directory)) {
+		writerThread = std::thread(runWriterThread, this);
+	}
+
+	ChunkStorage::~ChunkStorage() {
+		{
+			std::scoped_lock<std::mutex> lock { saveQueueMutex };
+			stopping = true;
+		}
+		saveQueueCondVar.notify_all();
+		writerThread.join();
+	}
+
+	void ChunkStorage::saveChunk(const Chunk& chunk) {
+		{
+			std::scoped_lock<std::mutex> lock { saveQueueMutex };
+			PendingSave& pendingSave = pendingSaves[chunk.getChunkCoord()];
+			pendingSave.blockData = chunk.getBlockDataSnapshot();
+			pendingSave.fluidData = chunk.getFluidDataSnapshot();
+			pendingSave.compressedContents.reset();
+			if (pendingSave.queued) return; // the writer hasn't started writing the older data yet, so it'll write the new data instead
+			pendingSave.queued = true;
+			saveQueue.push_back(chunk.getChunkCoord());
+		}
+		saveQueueCondVar.notify_one();
+	}
+	void ChunkStorage::saveChunk(const ChunkCoord& chunkCoord, std::shared_ptr<const Chunk::CompressedContents> compressedContents) {
+		{
+			std::scoped_lock<std::mutex> lock { saveQueueMutex };
+			PendingSave& pendingSave = pendingSaves[chunkCoord];
+			pendingSave.blockData.reset();
+			pendingSave.fluidData.reset();
+			pendingSave.compressedContents = std::move(compressedContents);
+			if (pendingSave.queued) return;
+			pendingSave.queued = true;
+			saveQueue.push_back(chunkCoord);
+		}
+		saveQueueCondVar.notify_one();
+	}
+
+	bool ChunkStorage::hasChunk(const ChunkCoord& chunkCoord) {
+		{
+			std::scoped_lock<std::mutex> lock { saveQueueMutex };
+			if (pendingSaves.contains(chunkCoord)) return true;
+		}
+		const RegionFile* const regionFile = getRegionFile(RegionFile::getRegionCoord(chunkCoord), false);
+		return regionFile && regionFile->contains(chunkCoord);
+	}
+
+	std::optional<Chunk::Contents> ChunkStorage::loadChunk(const ChunkCoord& chunkCoord) {
+		std::shared_ptr<const Chunk::CompressedContents> compressedContents;
+		{
+			std::scoped_lock<std::mutex> lock { saveQueueMutex };
+			if (const auto it = pendingSaves.find(chunkCoord); it != pendingSaves.end()) {
+				compressedContents = it->second.compressedContents;
+				// the chunk shares the snapshots with the writer, and copies them before modifying them (see Chunk::makeUnique)
+				if (!compressedContents) {
+					return Chunk::Contents {
+						std::const_pointer_cast<Chunk::BlockData>(it->second.blockData),
+						std::const_pointer_cast<Chunk::FluidData>(it->second.fluidData),
+					};
+				}
+			}
+		}
+		if (compressedContents) // decompressed outside of the lock, so that the writer isn't blocked
+			return Chunk::Contents { compressedContents->blockData.decompress(), compressedContents->fluidData.decompress() };
+		RegionFile* const regionFile = getRegionFile(RegionFile::getRegionCoord(chunkCoord), false);
+		if (!regionFile) return std::nullopt;
+		try {
+			const std::vector<unsigned char> bytes = regionFile->read(chunkCoord);
+			if (bytes.empty()) return std::nullopt;
+			return deserialize(bytes);
+		} catch (const std::exception& e) {
+			std::cerr << "Failed to load chunk " << glm::to_string(static_cast<glm::ivec3>(chunkCoord)) << ": " << e.what() << '\n';
+			return std::nullopt;
+		}
+	}
+
+	void ChunkStorage::flush() {
+		std::unique_lock<std::mutex> lock { saveQueueMutex };
+		savesWrittenCondVar.wait(lock, [this]() { return pendingSaves.empty(); });
+	}
+
+	RegionFile* ChunkStorage::getRegionFile(const ChunkCoord& regionCoord, const bool create) {
+		std::scoped_lock<std::mutex> lock { regionFilesMutex };
+		auto it = regionFiles.find(regionCoord);
+		if ((it != regionFiles.end()) && (it->second || !create))
+			return it->second.get();
+		const std::filesystem::path path = directory /
+			("r." + std::to_string(regionCoord.x) + '.' + std::to_string(regionCoord.y) + '.' + std::to_string(regionCoord.z) + ".region");
+		std::unique_ptr<RegionFile> regionFile {};
+		if (create) {
+			std::filesystem::create_directories(directory); // when the first chunk is saved, so worlds that are never modified don't leave a directory
+			regionFile = std::make_unique<RegionFile>(path);
+		} else if (std::filesystem::exists(path)) {
+			regionFile = std::make_unique<RegionFile>(path);
+		}
+		// missing region files are cached as nullptr, so that chunks in unsaved regions don't have to check the file system
+		return (regionFiles[regionCoord] = std::move(regionFile)).get();
+	}
+
+	void ChunkStorage::runWriterThread(ChunkStorage* const storage) {
+		std::unique_lock<std::mutex> lock { storage->saveQueueMutex };
+		while (true) {
+			storage->saveQueueCondVar.wait(lock, [storage]() { return storage->stopping || !storage->saveQueue.empty(); });
+			if (storage->saveQueue.empty()) break; // stopping, and every queued save has been written
+
+			const ChunkCoord chunkCoord = storage->saveQueue.front();
+			storage->saveQueue.pop_front();
+			PendingSave& pendingSave = storage->pendingSaves.at(chunkCoord);
+			pendingSave.queued = false;
+			Chunk::BlockDataSnapshot blockData = pendingSave.blockData;
+			Chunk::FluidDataSnapshot fluidData = pendingSave.fluidData;
+			std::shared_ptr<const Chunk::CompressedContents> compressedContents = pendingSave.compressedContents;
+			lock.unlock();
+
+			try {
+				if (compressedContents) {
+					blockData = compressedContents->blockData.decompress();
+					fluidData = compressedContents->fluidData.decompress();
+					compressedContents.reset();
+				}
+				const std::vector<unsigned char> bytes = serialize(*blockData, *fluidData);
+				const std::vector<unsigned char> compressed = compressBytes(bytes);
+				storage->getRegionFile(RegionFile::getRegionCoord(chunkCoord), true)->write(chunkCoord, compressed, bytes.size());
+			} catch (const std::exception& e) {
+				std::cerr << "Failed to save chunk " << glm::to_string(static_cast<glm::ivec3>(chunkCoord)) << ": " << e.what() << '\n';
+			}
+			blockData.reset();
+			fluidData.reset();
+
+			lock.lock();
+			// if the chunk was saved again while it was being written, the newer data is still queued
+			if (const auto it = storage->pendingSaves.find(chunkCoord); (it != storage->pendingSaves.end()) && !it->second.queued)
+				storage->pendingSaves.erase(it);
+			storage->savesWrittenCondVar.notify_all();
+		}
+	}
+
+
+	template<typename Data, typename F>
+	static nbt::nbt_compound palettedDataToNBT(const Data& data, F&& stateToNBT) {
+		std::vector<nbt::nbt_compound> palette;
+		palette.reserve(data.getPaletteSize());
+		for (const auto& state : data.getPalette())
+			palette.push_back(stateToNBT(state));
+		nbt::nbt_compound compound;
+		compound["palette"] = nbt::nbt_list(std::move(palette));
+		if (const auto& words = data.getPackedIndices(); !words.empty()) { // uniform data doesn't have any indices
+			std::vector<nbt::nbt_long> indices(words.size());
+			std::transform(words.begin(), words.end(), indices.begin(), [](const auto word) { return static_cast<nbt::nbt_long>(word); });
+			compound["indices"] = nbt::nbt_list(std::move(indices));
+		}
+		return compound;
+	}
+
+	template<typename Data, typename F>
+	static std::shared_ptr<Data> palettedDataFromNBT(const nbt::nbt_compound& compound, F&& stateFromNBT) {
+		const auto& paletteNBT = compound.at<nbt::TagList>("palette").asCompounds();
+		std::vector<typename Data::value_type> palette;
+		palette.reserve(paletteNBT.size());
+		for (const auto& entry : paletteNBT)
+			palette.push_back(stateFromNBT(entry));
+		std::vector<typename Data::word_t> words;
+		if (compound.hasKey("indices")) {
+			const auto& indices = compound.at<nbt::TagList>("indices").asLongs();
+			words.resize(indices.size());
+			std::transform(indices.begin(), indices.end(), words.begin(), [](const nbt::nbt_long index) { return static_cast<typename Data::word_t>(index); });
+		}
+		auto data = std::make_shared<Data>();
+		data->assignPacked(std::move(palette), std::move(words));
+		return data;
+	}
+
+	std::vector<unsigned char> ChunkStorage::serialize(const Chunk::BlockData& blockData, const Chunk::FluidData& fluidData) {
+		// states are saved by name, so that saves don't depend on the order of the registries
+		nbt::nbt_compound root;
+		root["version"] = chunk_data_version;
+		root["blocks"] = palettedDataToNBT(blockData, [](const BlockState& state) {
+			nbt::nbt_compound entry;
+			entry["name"] = state.getBlock().getName();
+			entry["metadata"] = static_cast<nbt::nbt_long>(state.getMetadata());
+			return entry;
+		});
+		root["fluids"] = palettedDataToNBT(fluidData, [](const FluidState& state) {
+			nbt::nbt_compound entry;
+			entry["name"] = state.getFluid().getName();
+			entry["metadata"] = static_cast<nbt::nbt_int>(state.getMetadata());
+			return entry;
+		});
+		return nbt::NBT(std::move(root)).toBinary("chunk");
+	}
+
+	Chunk::Contents ChunkStorage::deserialize(std::span<const unsigned char> bytes) {
+		const nbt::NBT nbt = nbt::parseNBT(bytes);
+		const nbt::nbt_compound& root = nbt.asCompound();
+		if (const auto version = root.at<nbt::TagInt>("version"); version != chunk_data_version)
+			throw std::runtime_error("Unsupported chunk data version " + std::to_string(version));
+		return {
+			palettedDataFromNBT<Chunk::BlockData>(root.at<nbt::TagCompound>("blocks"), [](const nbt::nbt_compound& entry) {
+				return BlockState(block_registry[entry.at<nbt::TagString>("name")], static_cast<BlockState::metadata_t>(entry.at<nbt::TagLong>("metadata")));
+			}),
+			palettedDataFromNBT<Chunk::FluidData>(root.at<nbt::TagCompound>("fluids"), [](const nbt::nbt_compound& entry) {
+				return FluidState(fluid_registry[entry.at<nbt::TagString>("name")], static_cast<FluidState::metadata_t>(entry.at<nbt::TagInt>("metadata")));
+			}),
+		};
+	}
+
+}
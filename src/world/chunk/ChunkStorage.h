@@ -0,0 +1,86 @@
+#pragma once
+
+#include <memory>
+#include <optional>
+#include <unordered_map>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <filesystem>
+#include <vector>
+#include <span>
+
+#include "Chunk.h"
+#include "ChunkCoord.h"
+#include "RegionFile.h"
+
+namespace eng {
+
+	/*
+	 * Saves chunks to, and loads chunks from, the region files in a directory.
+	 * Saving a chunk only takes snapshots of its data (or of its compressed data). The snapshots are decompressed if needed, serialized,
+	 * compressed, and written by a background thread, and loads of chunks that are still waiting to be written are served from their snapshots.
+	 */
+	class ChunkStorage {
+	private:
+		struct PendingSave {
+			// either the snapshots, or the compressed contents of a chunk that was saved while it was compressed
+			Chunk::BlockDataSnapshot blockData;
+			Chunk::FluidDataSnapshot fluidData;
+			std::shared_ptr<const Chunk::CompressedContents> compressedContents;
+			bool queued = false; // whether the chunk is in saveQueue
+		};
+
+		std::filesystem::path directory;
+
+		mutable std::mutex regionFilesMutex;
+		std::unordered_map<ChunkCoord, std::unique_ptr<RegionFile>> regionFiles; // open region files, by region coordinate
+
+		std::mutex saveQueueMutex;
+		std::condition_variable saveQueueCondVar;
+		std::condition_variable savesWrittenCondVar;
+		std::unordered_map<ChunkCoord, PendingSave> pendingSaves; // chunks that haven't been written yet
+		std::deque<ChunkCoord> saveQueue;
+		bool stopping = false;
+		std::thread writerThread;
+
+	public:
+		// region files are stored in directory, which is created when the first chunk is written if it doesn't exist
+		explicit ChunkStorage(std::filesystem::path directory);
+
+		ChunkStorage(const ChunkStorage&) = delete;
+		ChunkStorage& operator =(const ChunkStorage&) = delete;
+
+		// writes all pending saves before returning
+		~ChunkStorage();
+
+		inline const std::filesystem::path& getDirectory() const noexcept { return directory; }
+
+		// queues the chunk's current data to be written
+		void saveChunk(const Chunk& chunk);
+		// queues the compressed data of a chunk to be written, which is decompressed on the writer thread instead of the caller's
+		void saveChunk(const ChunkCoord& chunkCoord, std::shared_ptr<const Chunk::CompressedContents> compressedContents);
+
+		// whether the chunk has been saved (or is queued to be saved)
+		bool hasChunk(const ChunkCoord& chunkCoord);
+
+		// returns the saved data of a chunk, or nullopt if the chunk hasn't been saved (or its saved data can't be read)
+		std::optional<Chunk::Contents> loadChunk(const ChunkCoord& chunkCoord);
+
+		// blocks until every queued save has been written
+		void flush();
+
+		// binary NBT representation of a chunk's data
+		static std::vector<unsigned char> serialize(const Chunk::BlockData& blockData, const Chunk::FluidData& fluidData);
+		// throws if the data is invalid
+		static Chunk::Contents deserialize(std::span<const unsigned char> bytes);
+
+	private:
+		// returns nullptr if the region file doesn't exist and create is false
+		RegionFile* getRegionFile(const ChunkCoord& regionCoord, bool create);
+
+		static void runWriterThread(ChunkStorage* const storage);
+	};
+
+}
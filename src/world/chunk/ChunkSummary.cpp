@@ -0,0 +1,93 @@
+#include "ChunkSummary.h"
+
+#include <vector>
+
+#include "block/Block.h"
+#include "fluid/Fluid.h"
+
+namespace eng {
+
+	static constexpr int max_pos = static_cast<int>(chunk_width - 1);
+
+	// returns the face mask bits of the chunk faces that cPos is on
+	static ChunkSummary::face_mask getFaces(const glm::ivec3& cPos) noexcept {
+		ChunkSummary::face_mask faces = 0;
+		if (cPos.y == 0) faces |= 1 << static_cast<int>(Direction::DOWN);
+		if (cPos.y == max_pos) faces |= 1 << static_cast<int>(Direction::UP);
+		if (cPos.z == 0) faces |= 1 << static_cast<int>(Direction::NORTH);
+		if (cPos.z == max_pos) faces |= 1 << static_cast<int>(Direction::SOUTH);
+		if (cPos.x == 0) faces |= 1 << static_cast<int>(Direction::WEST);
+		if (cPos.x == max_pos) faces |= 1 << static_cast<int>(Direction::EAST);
+		return faces;
+	}
+
+	// returns the position of cell (u, v) of a face of the chunk
+	static glm::ivec3 getFacePos(const Direction face, const int u, const int v) noexcept {
+		switch (face) {
+			case Direction::DOWN: return { u, 0, v };
+			case Direction::UP: return { u, max_pos, v };
+			case Direction::NORTH: return { u, v, 0 };
+			case Direction::SOUTH: return { u, v, max_pos };
+			case Direction::WEST: return { 0, u, v };
+			case Direction::EAST: return { max_pos, u, v };
+			default: return { 0, 0, 0 };
+		}
+	}
+
+	ChunkSummary::face_mask ChunkSummary::getOpaqueFaces() const noexcept {
+		face_mask faces = 0;
+		for (const Direction face : direction::directions)
+			if (isFaceOpaque(face)) faces |= 1 << static_cast<int>(face);
+		return faces;
+	}
+
+	void ChunkSummary::computeBlocks(const BlockData& blockData) {
+		nonEmptyBlocks = 0;
+		modelBlocks = 0;
+		// check each palette entry once instead of each block
+		const auto& palette = blockData.getPalette();
+		std::vector<bool> opaqueEntries(palette.size());
+		for (size_t p = 0; p < palette.size(); p++) {
+			const BlockState& blockState = palette[p];
+			const auto count = static_cast<uint32_t>(blockData.getPaletteCount(static_cast<BlockData::palette_index_t>(p)));
+			if (count == 0) continue;
+			if (!blockState.isEmpty()) nonEmptyBlocks += count;
+			if (blockState.getBlock().hasModel(blockState)) modelBlocks += count;
+			opaqueEntries[p] = blockState.isFullOpaqueCube();
+		}
+		for (const Direction face : direction::directions) {
+			uint16_t opaqueBlocks = 0;
+			for (int v = 0; v < static_cast<int>(chunk_width); v++)
+				for (int u = 0; u < static_cast<int>(chunk_width); u++)
+					if (opaqueEntries[blockData.getPaletteIndex(BlockData::posToIndex(getFacePos(face, u, v)))]) opaqueBlocks++;
+			opaqueFaceBlocks[static_cast<size_t>(face)] = opaqueBlocks;
+		}
+	}
+
+	void ChunkSummary::computeFluids(const FluidData& fluidData) {
+		fluidCells = 0;
+		const auto& palette = fluidData.getPalette();
+		for (size_t p = 0; p < palette.size(); p++) {
+			if (!palette[p].isEmpty())
+				fluidCells += static_cast<uint32_t>(fluidData.getPaletteCount(static_cast<FluidData::palette_index_t>(p)));
+		}
+	}
+
+	void ChunkSummary::onBlockChanged(const glm::ivec3& cPos, BlockStateRef prevState, BlockStateRef blockState) {
+		if (prevState == blockState) return;
+		nonEmptyBlocks += static_cast<uint32_t>(!blockState.isEmpty()) - static_cast<uint32_t>(!prevState.isEmpty());
+		modelBlocks += static_cast<uint32_t>(blockState.getBlock().hasModel(blockState)) - static_cast<uint32_t>(prevState.getBlock().hasModel(prevState));
+		if (const face_mask faces = getFaces(cPos); faces != 0) {
+			const int opaqueChange = static_cast<int>(blockState.isFullOpaqueCube()) - static_cast<int>(prevState.isFullOpaqueCube());
+			if (opaqueChange == 0) return;
+			for (const Direction face : direction::directions)
+				if (faces & (1 << static_cast<int>(face)))
+					opaqueFaceBlocks[static_cast<size_t>(face)] = static_cast<uint16_t>(opaqueFaceBlocks[static_cast<size_t>(face)] + opaqueChange);
+		}
+	}
+
+	void ChunkSummary::onFluidChanged(FluidStateRef prevState, FluidStateRef fluidState) noexcept {
+		fluidCells += static_cast<uint32_t>(!fluidState.isEmpty()) - static_cast<uint32_t>(!prevState.isEmpty());
+	}
+
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <cstddef>
+
+#include <glm/vec3.hpp>
+
+#include "chunk_consts.h"
+#include "PalettedChunkData.h"
+#include "block/BlockState.h"
+#include "fluid/FluidState.h"
+#include "util/direction.h"
+
+namespace eng {
+
+	/*
+	 * Counts of what a chunk contains, so that code that skips chunks which can't contribute anything (e.g. chunks that are all air)
+	 * doesn't have to read the chunk's data.
+	 * The summary is computed when a chunk is generated or loaded, and updated whenever a block or fluid in the chunk is set.
+	 */
+	class ChunkSummary {
+	public:
+		using BlockData = PalettedChunkData<BlockState, chunk_width>;
+		using FluidData = PalettedChunkData<FluidState, chunk_width>;
+		using face_mask = uint8_t; // one bit per Direction
+
+		static constexpr face_mask all_faces = 0b111111;
+
+	private:
+		uint32_t nonEmptyBlocks = 0;
+		uint32_t modelBlocks = 0; // blocks that have a model
+		uint32_t fluidCells = 0; // blocks that contain a non-empty fluid
+		std::array<uint16_t, 6> opaqueFaceBlocks {}; // number of full opaque cubes on each face of the chunk, indexed by Direction
+
+	public:
+		ChunkSummary() = default;
+		ChunkSummary(const BlockData& blockData, const FluidData& fluidData) {
+			computeBlocks(blockData);
+			computeFluids(fluidData);
+		}
+
+		inline size_t getNonEmptyBlocks() const noexcept { return nonEmptyBlocks; }
+		inline size_t getFluidCells() const noexcept { return fluidCells; }
+		inline bool hasBlocks() const noexcept { return nonEmptyBlocks > 0; }
+		inline bool hasModelBlocks() const noexcept { return modelBlocks > 0; }
+		inline bool hasFluids() const noexcept { return fluidCells > 0; }
+		// whether meshing the chunk can produce any quads
+		inline bool canRender() const noexcept { return (modelBlocks > 0) || (fluidCells > 0); }
+
+		// whether every block on a face of the chunk is a full opaque cube
+		inline bool isFaceOpaque(const Direction face) const noexcept {
+			return opaqueFaceBlocks[static_cast<size_t>(face)] == chunk_layer_size;
+		}
+		face_mask getOpaqueFaces() const noexcept;
+
+		// recomputes the block counts from the chunk's block data
+		void computeBlocks(const BlockData& blockData);
+		// recomputes the fluid counts from the chunk's fluid data
+		void computeFluids(const FluidData& fluidData);
+
+		// cPos is relative to chunk origin
+		void onBlockChanged(const glm::ivec3& cPos, BlockStateRef prevState, BlockStateRef blockState);
+		void onFluidChanged(FluidStateRef prevState, FluidStateRef fluidState) noexcept;
+	};
+
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+#include <span>
+#include <cstring>
+#include <cstddef>
+
+#include "util/IOUtils.h"
+
+namespace eng {
+
+	/*
+	 * A zlib-compressed copy of a PalettedChunkData, for chunks that stay loaded without being accessed.
+	 * The palette is kept as is, and only the bit-packed palette indices are compressed. Palette indices of neighboring cells are usually
+	 * the same, so the indices of most terrain chunks compress to a small fraction of their size.
+	 */
+	template<typename Data>
+	class CompressedChunkData {
+	public:
+		using value_type = typename Data::value_type;
+		using word_t = typename Data::word_t;
+
+		// fastest zlib level, because data is compressed on a background thread but decompressed on the main thread when it's accessed
+		static constexpr int compression_level = 1;
+
+	private:
+		std::vector<value_type> palette;
+		std::vector<unsigned char> compressedIndices;
+		size_t wordCount = 0;
+
+	public:
+		CompressedChunkData() = default;
+		explicit CompressedChunkData(const Data& data) : palette(data.getPalette()), wordCount(data.getPackedIndices().size()) {
+			if (wordCount == 0) return; // a single palette entry doesn't need any indices
+			const auto& words = data.getPackedIndices();
+			compressedIndices = compressBytes({ reinterpret_cast<const unsigned char*>(words.data()), wordCount * sizeof(word_t) }, compression_level);
+			compressedIndices.shrink_to_fit();
+		}
+
+		std::shared_ptr<Data> decompress() const {
+			std::vector<word_t> words(wordCount);
+			if (wordCount > 0) {
+				const auto bytes = decompressBytes(compressedIndices, wordCount * sizeof(word_t));
+				std::memcpy(words.data(), bytes.data(), bytes.size());
+			}
+			auto data = std::make_shared<Data>();
+			data->assignPacked(palette, std::move(words));
+			return data;
+		}
+
+		// the size of the packed indices before compression, in bytes
+		inline size_t getUncompressedSize() const noexcept { return wordCount * sizeof(word_t); }
+		inline size_t getCompressedSize() const noexcept { return compressedIndices.size(); }
+
+		// approximate number of bytes of heap memory used by this data
+		inline size_t getMemoryUsage() const noexcept {
+			return (palette.capacity() * sizeof(value_type)) + compressedIndices.capacity();
+		}
+	};
+
+}
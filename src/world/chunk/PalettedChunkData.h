@@ -0,0 +1,420 @@
+#pragma once
+
+#include <array>
+#include <vector>
+#include <unordered_map>
+#include <utility>
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <stdexcept>
+#include <cstdint>
+#include <cstddef>
+
+#include <glm/vec3.hpp>
+
+#include "ChunkData.h"
+#include "util/math/math.h"
+
+
+namespace eng {
+
+	/*
+	 * Palette-compressed ChunkData
+	 * Each distinct state is stored once in a palette, and each cell stores a bit-packed index into the palette.
+	 * The index width grows with the palette (0, 1, 2, 4, 8, or 16 bits per cell),
+	 * so a chunk that only contains a single state doesn't store any indices at all.
+	 * Palette entries that are no longer referenced by any cell are reused before the index width is increased.
+	 */
+	template<typename StateType, size_t S, ChunkDataOrder Order = ChunkDataOrder::ZYX>
+	class PalettedChunkData {
+	public:
+		using value_type = StateType;
+		using palette_index_t = uint16_t;
+		using word_t = uint64_t;
+
+		static constexpr size_t width = S;
+		static constexpr size_t layer_size = S * S;
+		static constexpr size_t volume = S * S * S;
+		static_assert(volume <= (size_t{1} << (sizeof(palette_index_t) * 8)), "PalettedChunkData volume is too large for the palette index type");
+
+		class reference;
+		class const_iterator;
+	private:
+		static constexpr size_t word_bits = sizeof(word_t) * 8;
+		static constexpr size_t word_bits_log2 = constexpr_floor_log2(word_bits);
+		static constexpr size_t max_index_bits_log2 = 4; // 16 bits per index
+		static constexpr size_t max_linear_search_size = 16; // palettes larger than this use a hash map for reverse lookups
+
+		std::vector<StateType> palette;
+		std::vector<uint32_t> paletteCounts; // number of cells that reference each palette entry
+		std::unordered_map<StateType, palette_index_t> paletteLookup; // only populated for large palettes
+		std::vector<word_t> words; // bit-packed palette indices
+		uint8_t indexBitsLog2 = 0; // log2 of the index width (only meaningful if words isn't empty)
+		size_t freeEntries = 0; // number of palette entries that aren't referenced by any cell
+
+	public:
+		explicit PalettedChunkData() : PalettedChunkData(StateType{}) {}
+		explicit PalettedChunkData(const StateType& fillState) : palette{ fillState }, paletteCounts{ static_cast<uint32_t>(volume) } {}
+		explicit PalettedChunkData(const ChunkData<StateType, S, Order>& data) : PalettedChunkData() {
+			assign(data.data());
+		}
+
+		PalettedChunkData(const PalettedChunkData&) = default;
+		PalettedChunkData(PalettedChunkData&&) noexcept = default;
+		PalettedChunkData& operator =(const PalettedChunkData&) = default;
+		PalettedChunkData& operator =(PalettedChunkData&&) noexcept = default;
+
+		static inline constexpr size_t getWidth() noexcept { return width; }
+		static inline constexpr size_t getLayerSize() noexcept { return layer_size; }
+		static inline constexpr size_t getVolume() noexcept { return volume; }
+		inline constexpr size_t size() const noexcept { return volume; }
+
+		static inline constexpr ChunkDataOrder getDataOrder() noexcept { return Order; }
+
+		// p is relative to the data origin
+		static inline constexpr size_t posToIndex(const glm::ivec3& p) noexcept {
+			return ChunkData<StateType, S, Order>::posToIndex(p);
+		}
+		static inline constexpr glm::ivec3 indexToPos(const size_t i) noexcept {
+			return ChunkData<StateType, S, Order>::indexToPos(i);
+		}
+		// calls func(index, pos) for every cell, in storage order
+		template<typename Func>
+		static inline constexpr void forEachPos(Func&& func) {
+			ChunkData<StateType, S, Order>::forEachPos(std::forward<Func>(func));
+		}
+
+		// returns the number of bits used to store the palette index of each cell
+		inline size_t getIndexBits() const noexcept { return words.empty() ? 0 : (size_t{1} << indexBitsLog2); }
+		// returns the number of palette entries (including unreferenced entries)
+		inline size_t getPaletteSize() const noexcept { return palette.size(); }
+		// returns the number of distinct states stored in this data
+		inline size_t getDistinctStates() const noexcept { return palette.size() - freeEntries; }
+		inline const std::vector<StateType>& getPalette() const noexcept { return palette; }
+		// the bit-packed palette indices (empty if the palette only has a single entry)
+		inline const std::vector<word_t>& getPackedIndices() const noexcept { return words; }
+		// returns the number of cells containing the palette entry at the given palette index
+		inline size_t getPaletteCount(const palette_index_t paletteIndex) const noexcept { return paletteCounts[paletteIndex]; }
+
+		// whether at least one cell contains the given state
+		inline bool contains(const StateType& state) const {
+			const auto p = findPaletteEntry(state);
+			return (p >= 0) && (paletteCounts[p] > 0);
+		}
+
+		// whether every cell contains the same state
+		inline bool isUniform() const noexcept { return getDistinctStates() == 1; }
+		// the state of the first cell, which is the state of every cell if isUniform() is true
+		inline const StateType& getUniformState() const noexcept { return palette[getPaletteIndex(0)]; }
+
+		// approximate number of bytes of heap memory used by this data
+		inline size_t getMemoryUsage() const noexcept {
+			return (palette.capacity() * sizeof(StateType)) + (paletteCounts.capacity() * sizeof(uint32_t)) +
+				(paletteLookup.size() * (sizeof(StateType) + sizeof(palette_index_t) + sizeof(void*) * 2)) +
+				(words.capacity() * sizeof(word_t));
+		}
+
+		inline palette_index_t getPaletteIndex(const size_t i) const noexcept {
+			if (words.empty()) return 0;
+			const size_t indicesPerWordLog2 = word_bits_log2 - indexBitsLog2;
+			const size_t shift = (i & ((size_t{1} << indicesPerWordLog2) - 1)) << indexBitsLog2;
+			const word_t mask = (word_t{1} << (size_t{1} << indexBitsLog2)) - 1;
+			return static_cast<palette_index_t>((words[i >> indicesPerWordLog2] >> shift) & mask);
+		}
+
+		inline const StateType& get(const size_t i) const noexcept { return palette[getPaletteIndex(i)]; }
+		inline const StateType& get(const glm::ivec3& p) const noexcept { return get(posToIndex(p)); }
+
+		// returns true if the state of the cell was changed
+		bool set(const size_t i, const StateType& state) {
+			const palette_index_t prevIndex = getPaletteIndex(i);
+			if (palette[prevIndex] == state) return false;
+			const palette_index_t newIndex = addPaletteEntry(state);
+			setPaletteIndex(i, newIndex);
+			acquirePaletteEntry(newIndex);
+			releasePaletteEntry(prevIndex);
+			if (paletteCounts[newIndex] == volume) fill(state); // collapse to a single state
+			return true;
+		}
+		inline bool set(const glm::ivec3& p, const StateType& state) { return set(posToIndex(p), state); }
+
+		inline const StateType& operator [](const size_t i) const noexcept { return get(i); }
+		inline reference operator [](const size_t i) noexcept { return { *this, i }; }
+		inline const StateType& operator [](const glm::ivec3& p) const noexcept { return get(posToIndex(p)); }
+		inline reference operator [](const glm::ivec3& p) noexcept { return { *this, posToIndex(p) }; }
+
+		inline const StateType& at(const size_t i) const {
+			if (i >= volume) throw std::out_of_range("PalettedChunkData index out of range");
+			return get(i);
+		}
+		inline reference at(const size_t i) {
+			if (i >= volume) throw std::out_of_range("PalettedChunkData index out of range");
+			return { *this, i };
+		}
+		inline const StateType& at(const glm::ivec3& p) const { return at(posToIndex(p)); }
+		inline reference at(const glm::ivec3& p) { return at(posToIndex(p)); }
+
+		// sets every cell to the given state
+		void fill(const StateType& state) {
+			palette.assign(1, state);
+			paletteCounts.assign(1, static_cast<uint32_t>(volume));
+			paletteLookup.clear();
+			words.clear();
+			words.shrink_to_fit();
+			indexBitsLog2 = 0;
+			freeEntries = 0;
+		}
+
+		// replaces the contents with volume states read from src (in storage order)
+		void assign(const StateType* const src) {
+			fill(src[0]);
+			for (size_t i = 1; i < volume; i++)
+				set(i, src[i]);
+		}
+
+		// replaces the contents with a palette and bit-packed palette indices, as returned by getPalette() and getPackedIndices()
+		// the index width is determined by the number of words
+		void assignPacked(std::vector<StateType> newPalette, std::vector<word_t> newWords) {
+			if (newPalette.empty())
+				throw std::invalid_argument("PalettedChunkData palette is empty");
+			if (newWords.empty()) {
+				if (newPalette.size() != 1)
+					throw std::invalid_argument("PalettedChunkData has multiple palette entries but no indices");
+				fill(newPalette[0]);
+				return;
+			}
+			uint8_t newBitsLog2 = 0;
+			while ((newBitsLog2 <= max_index_bits_log2) && (getWordCount(newBitsLog2) != newWords.size()))
+				newBitsLog2++;
+			if ((newBitsLog2 > max_index_bits_log2) || (newPalette.size() > (size_t{1} << (size_t{1} << newBitsLog2))))
+				throw std::invalid_argument("PalettedChunkData index data doesn't match the palette size");
+
+			palette = std::move(newPalette);
+			words = std::move(newWords);
+			indexBitsLog2 = newBitsLog2;
+			paletteCounts.assign(palette.size(), 0);
+			for (size_t i = 0; i < volume; i++) {
+				const palette_index_t p = getPaletteIndex(i);
+				if (p >= palette.size()) {
+					fill(StateType{});
+					throw std::invalid_argument("PalettedChunkData index is out of the palette's range");
+				}
+				paletteCounts[p]++;
+			}
+			freeEntries = static_cast<size_t>(std::count(paletteCounts.begin(), paletteCounts.end(), uint32_t{0}));
+			rebuildPaletteLookup();
+		}
+
+		// copies count states starting at index start into dst
+		void copyTo(const size_t start, const size_t count, StateType* const dst) const {
+			if (words.empty()) {
+				std::fill_n(dst, count, palette[0]);
+			} else {
+				for (size_t i = 0; i < count; i++)
+					dst[i] = palette[getPaletteIndex(start + i)];
+			}
+		}
+
+		// removes unreferenced palette entries and shrinks the index width as much as possible
+		void compact() {
+			if (freeEntries == 0) return;
+			std::vector<palette_index_t> remap(palette.size(), 0);
+			std::vector<StateType> newPalette;
+			std::vector<uint32_t> newCounts;
+			newPalette.reserve(palette.size() - freeEntries);
+			newCounts.reserve(palette.size() - freeEntries);
+			for (size_t p = 0; p < palette.size(); p++) {
+				if (paletteCounts[p] > 0) {
+					remap[p] = static_cast<palette_index_t>(newPalette.size());
+					newPalette.push_back(palette[p]);
+					newCounts.push_back(paletteCounts[p]);
+				}
+			}
+			if (newPalette.size() == 1) {
+				fill(newPalette[0]);
+				return;
+			}
+			const uint8_t newBitsLog2 = getIndexBitsLog2(newPalette.size());
+			std::vector<word_t> newWords(getWordCount(newBitsLog2), 0);
+			for (size_t i = 0; i < volume; i++)
+				setPaletteIndex(newWords, newBitsLog2, i, remap[getPaletteIndex(i)]);
+			palette = std::move(newPalette);
+			paletteCounts = std::move(newCounts);
+			words = std::move(newWords);
+			indexBitsLog2 = newBitsLog2;
+			freeEntries = 0;
+			rebuildPaletteLookup();
+		}
+
+		inline bool empty() const {
+			for (size_t p = 0; p < palette.size(); p++) {
+				if ((paletteCounts[p] > 0) && !palette[p].isEmpty()) return false;
+			}
+			return true;
+		}
+
+		inline const_iterator begin() const noexcept { return { this, 0 }; }
+		inline const_iterator end() const noexcept { return { this, volume }; }
+		inline const_iterator cbegin() const noexcept { return { this, 0 }; }
+		inline const_iterator cend() const noexcept { return { this, volume }; }
+
+
+		// proxy reference to a single cell, returned by the non-const subscript operators
+		class reference {
+			friend class PalettedChunkData;
+		private:
+			PalettedChunkData* data;
+			size_t index;
+
+			reference(PalettedChunkData& data, const size_t index) noexcept : data(&data), index(index) {}
+		public:
+			reference(const reference&) noexcept = default;
+
+			inline reference& operator =(const StateType& state) {
+				data->set(index, state);
+				return *this;
+			}
+			inline reference& operator =(const reference& b) {
+				data->set(index, static_cast<const StateType&>(b));
+				return *this;
+			}
+
+			inline operator const StateType&() const noexcept { return data->get(index); }
+			inline const StateType& get() const noexcept { return data->get(index); }
+		};
+
+		class const_iterator {
+			friend class PalettedChunkData;
+		public:
+			using iterator_category = std::forward_iterator_tag;
+			using value_type = StateType;
+			using difference_type = std::ptrdiff_t;
+			using pointer = const StateType*;
+			using reference = const StateType&;
+		private:
+			const PalettedChunkData* data = nullptr;
+			size_t index = 0;
+
+			const_iterator(const PalettedChunkData* data, const size_t index) noexcept : data(data), index(index) {}
+		public:
+			const_iterator() noexcept = default;
+
+			inline reference operator *() const noexcept { return data->get(index); }
+			inline pointer operator ->() const noexcept { return &data->get(index); }
+
+			inline const_iterator& operator ++() noexcept {
+				index++;
+				return *this;
+			}
+			inline const_iterator operator ++(int) noexcept {
+				const_iterator it = *this;
+				index++;
+				return it;
+			}
+
+			inline bool operator ==(const const_iterator& b) const noexcept { return (data == b.data) && (index == b.index); }
+			inline bool operator !=(const const_iterator& b) const noexcept { return !(*this == b); }
+
+			// index of the cell that the iterator points to
+			inline size_t getIndex() const noexcept { return index; }
+		};
+
+	private:
+
+		static inline constexpr uint8_t getIndexBitsLog2(const size_t paletteSize) noexcept {
+			uint8_t bitsLog2 = 0;
+			while ((bitsLog2 < max_index_bits_log2) && ((size_t{1} << (size_t{1} << bitsLog2)) < paletteSize))
+				bitsLog2++;
+			return bitsLog2;
+		}
+		static inline constexpr size_t getWordCount(const uint8_t bitsLog2) noexcept {
+			return ((volume << bitsLog2) + word_bits - 1) >> word_bits_log2;
+		}
+
+		inline size_t getPaletteCapacity() const noexcept {
+			return words.empty() ? 1 : (size_t{1} << (size_t{1} << indexBitsLog2));
+		}
+
+		static inline void setPaletteIndex(std::vector<word_t>& words, const uint8_t bitsLog2, const size_t i, const palette_index_t paletteIndex) noexcept {
+			const size_t indicesPerWordLog2 = word_bits_log2 - bitsLog2;
+			const size_t shift = (i & ((size_t{1} << indicesPerWordLog2) - 1)) << bitsLog2;
+			const word_t mask = ((word_t{1} << (size_t{1} << bitsLog2)) - 1) << shift;
+			word_t& word = words[i >> indicesPerWordLog2];
+			word = (word & ~mask) | ((static_cast<word_t>(paletteIndex) << shift) & mask);
+		}
+		inline void setPaletteIndex(const size_t i, const palette_index_t paletteIndex) noexcept {
+			setPaletteIndex(words, indexBitsLog2, i, paletteIndex);
+		}
+
+		// repacks the palette indices using a larger index width
+		void widen(const uint8_t newBitsLog2) {
+			std::vector<word_t> newWords(getWordCount(newBitsLog2), 0);
+			if (!words.empty()) {
+				for (size_t i = 0; i < volume; i++)
+					setPaletteIndex(newWords, newBitsLog2, i, getPaletteIndex(i));
+			}
+			words = std::move(newWords);
+			indexBitsLog2 = newBitsLog2;
+		}
+
+		inline void rebuildPaletteLookup() {
+			paletteLookup.clear();
+			if (palette.size() > max_linear_search_size) {
+				for (size_t p = 0; p < palette.size(); p++)
+					paletteLookup.emplace(palette[p], static_cast<palette_index_t>(p));
+			}
+		}
+
+		// returns the palette index of an existing entry, or -1 if the state isn't in the palette
+		inline long findPaletteEntry(const StateType& state) const {
+			if (palette.size() > max_linear_search_size) {
+				const auto it = paletteLookup.find(state);
+				return (it != paletteLookup.end()) ? static_cast<long>(it->second) : -1;
+			}
+			for (size_t p = 0; p < palette.size(); p++) {
+				if (palette[p] == state) return static_cast<long>(p);
+			}
+			return -1;
+		}
+
+		// returns the palette index for the given state, adding it to the palette if necessary
+		// an added entry has a count of 0 until it is acquired
+		palette_index_t addPaletteEntry(const StateType& state) {
+			if (const auto existing = findPaletteEntry(state); existing >= 0)
+				return static_cast<palette_index_t>(existing);
+			if (freeEntries > 0) { // reuse an unreferenced entry
+				for (size_t p = 0; p < palette.size(); p++) {
+					if (paletteCounts[p] == 0) {
+						if (palette.size() > max_linear_search_size) {
+							paletteLookup.erase(palette[p]);
+							paletteLookup.emplace(state, static_cast<palette_index_t>(p));
+						}
+						palette[p] = state;
+						return static_cast<palette_index_t>(p);
+					}
+				}
+			}
+			if (palette.size() >= getPaletteCapacity())
+				widen(words.empty() ? 0 : (indexBitsLog2 + 1));
+			palette.push_back(state);
+			paletteCounts.push_back(0);
+			freeEntries++;
+			if (palette.size() == (max_linear_search_size + 1)) {
+				rebuildPaletteLookup();
+			} else if (palette.size() > max_linear_search_size) {
+				paletteLookup.emplace(state, static_cast<palette_index_t>(palette.size() - 1));
+			}
+			return static_cast<palette_index_t>(palette.size() - 1);
+		}
+
+		inline void acquirePaletteEntry(const palette_index_t paletteIndex) noexcept {
+			if (paletteCounts[paletteIndex]++ == 0) freeEntries--;
+		}
+		inline void releasePaletteEntry(const palette_index_t paletteIndex) noexcept {
+			if (--paletteCounts[paletteIndex] == 0) freeEntries++;
+		}
+
+	};
+
+}
@@ -0,0 +1,259 @@
+#include "ProtoChunk.h"
+
+#include <cmath>
+#include <numbers>
+
+#include <glm/common.hpp>
+#include <glm/geometric.hpp>
+
+#include "block/BlockRegistry.h"
+#include "util/math/CounterRNG.h"
+#include "TerrainDensity.h"
+#include "TerrainGenerator.h"
+
+namespace eng {
+
+	static constexpr int width = static_cast<int>(chunk_width);
+	static constexpr auto unsigned_width = static_cast<uint32_t>(chunk_width);
+
+	// tunnels start in a few chunks, and wander up to tunnel_length blocks from their start
+	static constexpr float tunnel_chance = 0.15f;
+	static constexpr int tunnel_length = 20;
+	static constexpr float tunnel_min_radius = 1.5f;
+	static constexpr float tunnel_max_radius = 3.0f;
+	static constexpr int tunnel_min_depth = 12; // tunnels only start this far below the terrain height, so they rarely break the surface
+	static_assert((static_cast<float>(tunnel_length) + tunnel_max_radius) < static_cast<float>(width), "Tunnels can't reach further than the neighboring chunks");
+
+	static constexpr float tall_grass_chance = 0.35f;
+
+	static constexpr int tree_attempts = 3; // per chunk
+	static constexpr float tree_chance = 0.3f;
+	static constexpr uint32_t min_trunk_height = 4;
+	static constexpr uint32_t max_trunk_height = 6;
+	static constexpr int leaves_radius = 2;
+	static_assert((static_cast<int>(max_trunk_height) + 1 < width) && (leaves_radius < width), "Trees can't reach further than the neighboring chunks");
+
+	// the random numbers of each feature are drawn from a counter-based RNG keyed by the feature and the chunk it starts in,
+	// so every number only depends on what it's used for, and not on the order that chunks or features are generated in
+	static constexpr uint64_t tunnel_feature = 1;
+	static constexpr uint64_t tall_grass_feature = 2; // the counter of each block is ((z * chunk_width) + y) * chunk_width + x
+	static constexpr uint64_t tree_feature = 3;
+
+	// counters of a tunnel's numbers, where each step draws 2 numbers after the first step counter
+	static constexpr CounterRNG::counter_t tunnel_first_step_counter = 7;
+	// counters of each tree attempt's numbers, which start at the attempt's index times tree_counters
+	static constexpr CounterRNG::counter_t tree_counters = 5;
+
+	static inline size_t getColumnIndex(const int x, const int z) noexcept {
+		return static_cast<size_t>((z * width) + x);
+	}
+
+	static inline bool isInChunk(const glm::ivec3& cPos) noexcept {
+		return (cPos.x >= 0) && (cPos.y >= 0) && (cPos.z >= 0) && (cPos.x < width) && (cPos.y < width) && (cPos.z < width);
+	}
+
+
+	const char* generation_stage::getName(const GenerationStage stage) noexcept {
+		switch (stage) {
+			case GenerationStage::Terrain: return "terrain";
+			case GenerationStage::Surface: return "surface";
+			case GenerationStage::Carvers: return "carvers";
+			case GenerationStage::Decoration: return "decoration";
+			case GenerationStage::Finalization: return "finalization";
+			default: return "unknown";
+		}
+	}
+
+
+	ProtoChunk::ProtoChunk(const ChunkCoord& chunkCoord) :
+			chunkCoord(chunkCoord),
+			blockPos(ChunkCoord::toBlockPos(chunkCoord)),
+			contents { std::make_shared<BlockData>(), std::make_shared<FluidData>() } {
+		surface.fill(no_surface);
+	}
+
+	void ProtoChunk::runNextStage(const TerrainGenerator& terrain, const Neighborhood& neighbors) {
+		switch (getNextStage()) {
+			case GenerationStage::Terrain: generateTerrain(terrain); break;
+			case GenerationStage::Surface: generateSurface(); break;
+			case GenerationStage::Carvers: carve(terrain); break;
+			case GenerationStage::Decoration: decorate(terrain, neighbors); break;
+			case GenerationStage::Finalization: finalize(); break;
+		}
+	}
+
+	void ProtoChunk::generateTerrain(const TerrainGenerator& terrain) {
+		// every chunk in the column shares the same terrain heights
+		const TerrainHeightCache::HeightsPtr terrainHeights = terrain.getColumnTerrainHeights({ chunkCoord.x, chunkCoord.z });
+		const TerrainDensity density(terrain.getTerrainDensityNoise(), blockPos, *terrainHeights);
+		TerrainDensity::Column columnDensity;
+		BlockData& blockData = *contents.blockData;
+		const BlockState stone { blocks::stone };
+		constexpr auto columnBelow = static_cast<size_t>(TerrainDensity::column_below);
+		for (int z = 0; z < width; z++) {
+			for (int x = 0; x < width; x++) {
+				density.getColumn(x, z, columnDensity);
+				for (size_t y = 0; y < chunk_width; y++) {
+					if (TerrainDensity::isSolid(columnDensity[y + columnBelow]))
+						blockData.set(Chunk::posToIndex(static_cast<size_t>(x), y, static_cast<size_t>(z)), stone);
+				}
+				// the surface stage needs to know how deep the top of the column is
+				uint8_t above = 0;
+				while ((above < TerrainDensity::column_above) && TerrainDensity::isSolid(columnDensity[columnBelow + chunk_width + above])) above++;
+				solidAbove[getColumnIndex(x, z)] = above;
+			}
+		}
+	}
+
+	void ProtoChunk::generateSurface() {
+		BlockData& blockData = *contents.blockData;
+		const BlockState dirt { blocks::dirt }, grass { blocks::grass };
+		for (int z = 0; z < width; z++) {
+			for (int x = 0; x < width; x++) {
+				// a single pass from the top of the column down, counting the solid blocks directly above each block to find its surface layer
+				int above = solidAbove[getColumnIndex(x, z)];
+				for (int y = width - 1; y >= 0; y--) {
+					const auto i = Chunk::posToIndex({ x, y, z });
+					const bool solid = !blockData.get(i).isEmpty();
+					if (solid && (above <= 2)) blockData.set(i, (above > 0) ? dirt : grass);
+					above = (solid) ? (above + 1) : 0;
+				}
+			}
+		}
+	}
+
+	void ProtoChunk::carve(const TerrainGenerator& terrain) {
+		// tunnels are carved by every chunk they pass through, so each chunk carves the tunnels that start in any of its neighbors
+		forEachNeighborOffset(1, [&](const glm::ivec3& offset) {
+			carveTunnel(terrain, ChunkCoord(chunkCoord + offset));
+		});
+		findSurface();
+	}
+
+	void ProtoChunk::carveTunnel(const TerrainGenerator& terrain, const ChunkCoord& originCoord) {
+		// every chunk that carves the tunnel draws the same numbers, whether or not the tunnel reaches it
+		const CounterRNG rand(terrain.getSeed(), tunnel_feature, originCoord);
+		if (rand.getFloat(0) >= tunnel_chance) return;
+		const glm::ivec3 start { glm::uvec3(rand.getUint32(1, unsigned_width), rand.getUint32(2, unsigned_width), rand.getUint32(3, unsigned_width)) };
+		const glm::ivec3 originPos = ChunkCoord::toBlockPos(originCoord);
+		const int terrainHeight = (*terrain.getColumnTerrainHeights({ originCoord.x, originCoord.z }))[getColumnIndex(start.x, start.z)];
+		if ((originPos.y + start.y) > (terrainHeight - tunnel_min_depth)) return;
+
+		BlockData& blockData = *contents.blockData;
+		glm::vec3 pos = static_cast<glm::vec3>(originPos + start - blockPos) + 0.5f; // relative to this chunk
+		float yaw = rand.getFloat(4) * 2.0f * std::numbers::pi_v<float>;
+		float pitch = (rand.getFloat(5) - 0.5f) * 0.5f;
+		const float radius = tunnel_min_radius + (rand.getFloat(6) * (tunnel_max_radius - tunnel_min_radius));
+		for (int step = 0; step < tunnel_length; step++) {
+			const glm::ivec3 cMin = glm::max(static_cast<glm::ivec3>(glm::floor(pos - radius)), glm::ivec3(0));
+			const glm::ivec3 cMax = glm::min(static_cast<glm::ivec3>(glm::floor(pos + radius)), glm::ivec3(width - 1));
+			for (int z = cMin.z; z <= cMax.z; z++) {
+				for (int y = cMin.y; y <= cMax.y; y++) {
+					for (int x = cMin.x; x <= cMax.x; x++) {
+						const glm::vec3 d = (glm::vec3(x, y, z) + 0.5f) - pos;
+						if (glm::dot(d, d) <= (radius * radius)) blockData.set(Chunk::posToIndex({ x, y, z }), blocks::empty_blockstate);
+					}
+				}
+			}
+			const auto stepCounter = tunnel_first_step_counter + (2 * static_cast<CounterRNG::counter_t>(step));
+			yaw += (rand.getFloat(stepCounter) - 0.5f) * 0.6f;
+			pitch = (pitch * 0.7f) + ((rand.getFloat(stepCounter + 1) - 0.5f) * 0.3f);
+			pos += glm::vec3(std::cos(yaw) * std::cos(pitch), std::sin(pitch), std::sin(yaw) * std::cos(pitch));
+		}
+	}
+
+	void ProtoChunk::findSurface() {
+		const BlockData& blockData = *contents.blockData;
+		const BlockState grass { blocks::grass };
+		for (int z = 0; z < width; z++) {
+			for (int x = 0; x < width; x++) {
+				int y = width - 1;
+				while ((y >= 0) && blockData.get(Chunk::posToIndex({ x, y, z })).isEmpty()) y--;
+				const bool isGrass = (y >= 0) && (blockData.get(Chunk::posToIndex({ x, y, z })) == grass);
+				surface[getColumnIndex(x, z)] = (isGrass) ? static_cast<int8_t>(y) : no_surface;
+			}
+		}
+	}
+
+	void ProtoChunk::decorate(const TerrainGenerator& terrain, const Neighborhood& neighbors) {
+		placeTallGrass(terrain, neighbors[getNeighborIndex({ 0, -1, 0 })]);
+		// trees are placed in the same order by every chunk they reach, so overlapping trees look the same on both sides of a chunk border
+		forEachNeighborOffset(1, [&](const glm::ivec3& offset) {
+			placeTrees(terrain, *neighbors[getNeighborIndex(offset)]);
+		});
+	}
+
+	void ProtoChunk::placeTallGrass(const TerrainGenerator& terrain, const ProtoChunk* const below) {
+		const CounterRNG rand(terrain.getSeed(), tall_grass_feature, chunkCoord);
+		BlockData& blockData = *contents.blockData;
+		const BlockState grass { blocks::grass }, tallGrass { blocks::tall_grass };
+		std::array<float, chunk_width> rolls;
+		for (int z = 0; z < width; z++) {
+			for (int y = 0; y < width; y++) {
+				// the rolls of a row of blocks along x are drawn at once
+				rand.fillFloat(static_cast<CounterRNG::counter_t>(((z * width) + y) * width), rolls);
+				for (int x = 0; x < width; x++) {
+					// the block under the bottom of the column is only known if it's the surface of the chunk below
+					// tall grass never replaces grass, so the block below is the same as before any tall grass was placed
+					const bool onGrass = (y > 0) ? (blockData.get(Chunk::posToIndex({ x, y - 1, z })) == grass) :
+						((below != nullptr) && (below->surface[getColumnIndex(x, z)] == (width - 1)));
+					const auto i = Chunk::posToIndex({ x, y, z });
+					if (onGrass && blockData.get(i).isEmpty() && (rolls[static_cast<size_t>(x)] < tall_grass_chance)) blockData.set(i, tallGrass);
+				}
+			}
+		}
+	}
+
+	void ProtoChunk::placeTrees(const TerrainGenerator& terrain, const ProtoChunk& origin) {
+		BlockData& blockData = *contents.blockData;
+		const BlockState log { blocks::log }, leaves { blocks::leaves }, tallGrass { blocks::tall_grass };
+		const auto place = [&](const glm::ivec3& pos, const BlockState& blockState) {
+			const glm::ivec3 cPos = pos - blockPos;
+			if (!isInChunk(cPos)) return;
+			const auto i = Chunk::posToIndex(cPos);
+			const BlockState prevState = blockData.get(i);
+			// leaves only grow into air, and logs also replace leaves
+			if (prevState.isEmpty() || (prevState == tallGrass) || ((blockState == log) && (prevState == leaves)))
+				blockData.set(i, blockState);
+		};
+
+		// every chunk that places the trees draws the same numbers, whether or not the trees reach it
+		const CounterRNG rand(terrain.getSeed(), tree_feature, origin.chunkCoord);
+		for (int t = 0; t < tree_attempts; t++) {
+			const auto counter = static_cast<CounterRNG::counter_t>(t) * tree_counters;
+			const float roll = rand.getFloat(counter);
+			const int x = static_cast<int>(rand.getUint32(counter + 1, unsigned_width));
+			const int z = static_cast<int>(rand.getUint32(counter + 2, unsigned_width));
+			const int trunkHeight = static_cast<int>(rand.getUint32(counter + 3, min_trunk_height, max_trunk_height + 1));
+			const uint32_t cornerBits = rand.getUint32(counter + 4); // which corners of the leaves are filled
+			const int ground = origin.surface[getColumnIndex(x, z)];
+			// the block above the top layer of a chunk isn't known, so trees don't grow there
+			if ((roll >= tree_chance) || (ground == no_surface) || (ground == (width - 1))) continue;
+
+			const glm::ivec3 base = origin.blockPos + glm::ivec3(x, ground + 1, z);
+			const glm::ivec3 top = base + glm::ivec3(0, trunkHeight - 1, 0);
+			// two wide layers of leaves below the top of the trunk, and two narrow layers around and above it
+			uint32_t corner = 0;
+			for (int dy = -2; dy <= 1; dy++) {
+				const int r = (dy < 0) ? leaves_radius : 1;
+				for (int dz = -r; dz <= r; dz++) {
+					for (int dx = -r; dx <= r; dx++) {
+						if ((std::abs(dx) == r) && (std::abs(dz) == r)) {
+							const bool filled = (dy < 1) && ((cornerBits >> (corner++ & 31)) & 1);
+							if (!filled) continue;
+						}
+						place(top + glm::ivec3(dx, dy, dz), leaves);
+					}
+				}
+			}
+			for (int y = 0; y < trunkHeight; y++)
+				place(base + glm::ivec3(0, y, 0), log);
+		}
+	}
+
+	void ProtoChunk::finalize() {
+		contents.heightmap.emplace(*contents.blockData);
+		contents.summary.emplace(*contents.blockData, *contents.fluidData);
+	}
+
+}
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <array>
+#include <algorithm>
+#include <utility>
+#include <cstdint>
+#include <cstddef>
+#include <cstdlib>
+
+#include <glm/vec3.hpp>
+
+#include "Chunk.h"
+#include "ChunkCoord.h"
+#include "chunk_consts.h"
+
+namespace eng {
+
+	class TerrainGenerator;
+
+	// the stages of generating a chunk, in the order they run
+	enum class GenerationStage : uint8_t {
+		Terrain, // fills the solid blocks of the terrain density with stone
+		Surface, // replaces the top layers of the terrain with grass and dirt
+		Carvers, // carves tunnels, which can cross chunk borders
+		Decoration, // places tall grass and trees, which can cross chunk borders
+		Finalization, // computes the chunk's heightmap and summary
+	};
+
+	namespace generation_stage {
+
+		constexpr std::array<GenerationStage, 5> stages {
+			GenerationStage::Terrain, GenerationStage::Surface, GenerationStage::Carvers, GenerationStage::Decoration, GenerationStage::Finalization,
+		};
+		constexpr size_t count = stages.size();
+
+		constexpr size_t getIndex(const GenerationStage stage) noexcept {
+			return static_cast<size_t>(stage);
+		}
+
+		// the radius in chunks of the neighbors that have to finish every earlier stage before a chunk can run this stage
+		// a stage can read the results of those neighbors' earlier stages, but only writes to its own chunk
+		constexpr int getNeighborRadius(const GenerationStage stage) noexcept {
+			switch (stage) {
+				case GenerationStage::Decoration: return 1; // trees can grow from the surface of a neighboring chunk
+				default: return 0;
+			}
+		}
+		constexpr int max_neighbor_radius = 1;
+
+		const char* getName(GenerationStage stage) noexcept;
+
+	}
+
+	/*
+	 * A chunk that is partway through generation.
+	 * Proto chunks are never added to the world's loaded chunks; the contents are only handed over once every stage has finished.
+	 * A stage only writes the proto chunk that runs it, and the results that neighboring chunks read (the surface) are written by an early stage
+	 * and never changed afterwards, so neighbors can read them while the chunk runs its later stages.
+	 */
+	class ProtoChunk {
+	public:
+		using BlockData = Chunk::BlockData;
+		using FluidData = Chunk::FluidData;
+		// the height relative to the chunk's origin of the grass block at the top of each column, or no_surface if the topmost block isn't grass
+		// indexed by (z * chunk_width) + x
+		using Surface = std::array<int8_t, chunk_layer_size>;
+		static constexpr int8_t no_surface = -1;
+		// the proto chunks around a chunk, indexed by getNeighborIndex(offset), where the chunk itself is at offset (0, 0, 0)
+		// only the chunks within the neighbor radius of the stage that is running are set, the rest are null
+		using Neighborhood = std::array<const ProtoChunk*, 27>;
+
+	private:
+		ChunkCoord chunkCoord;
+		glm::ivec3 blockPos;
+		Chunk::Contents contents;
+		std::array<uint8_t, chunk_layer_size> solidAbove {}; // solid terrain blocks directly above the top of each column, set by the terrain stage
+		Surface surface {}; // set by the carvers stage
+		size_t completedStages = 0;
+
+	public:
+		explicit ProtoChunk(const ChunkCoord& chunkCoord);
+
+		inline const ChunkCoord& getChunkCoord() const noexcept { return chunkCoord; }
+		inline size_t getCompletedStages() const noexcept { return completedStages; }
+		inline bool hasCompleted(const GenerationStage stage) const noexcept { return completedStages > generation_stage::getIndex(stage); }
+		inline bool isComplete() const noexcept { return completedStages == generation_stage::count; }
+		// the stage that runs next, if the chunk isn't complete
+		inline GenerationStage getNextStage() const noexcept { return generation_stage::stages[completedStages]; }
+		inline const Surface& getSurface() const noexcept { return surface; }
+
+		// runs the next stage of the chunk, which only counts as completed once completeStage() is called
+		// neighbors has to contain every chunk within the stage's neighbor radius, each of which has finished the stages before it
+		void runNextStage(const TerrainGenerator& terrain, const Neighborhood& neighbors);
+		// marks the stage that runNextStage() ran as completed
+		// the chunk generator calls this while holding its lock, since other threads read the completed stages while they hold it
+		inline void completeStage() noexcept { completedStages++; }
+
+		// moves the contents out of a complete chunk
+		inline Chunk::Contents takeContents() noexcept { return std::move(contents); }
+
+		static inline constexpr size_t getNeighborIndex(const glm::ivec3& offset) noexcept {
+			return static_cast<size_t>((((offset.z + 1) * 3) + (offset.y + 1)) * 3 + (offset.x + 1));
+		}
+		// calls f(offset) for the offset of every chunk within radius (including (0, 0, 0)), in the order of getNeighborIndex
+		template<typename F>
+		static void forEachNeighborOffset(const int radius, F&& f) {
+			for (int z = -radius; z <= radius; z++)
+				for (int y = -radius; y <= radius; y++)
+					for (int x = -radius; x <= radius; x++)
+						f(glm::ivec3(x, y, z));
+		}
+		// the number of chunks between two chunk coordinates, where every chunk around a chunk is at a distance of 1
+		static inline int getNeighborDistance(const ChunkCoord& a, const ChunkCoord& b) noexcept {
+			return std::max(std::max(std::abs(a.x - b.x), std::abs(a.y - b.y)), std::abs(a.z - b.z));
+		}
+
+	private:
+		void generateTerrain(const TerrainGenerator& terrain);
+		void generateSurface();
+		void carve(const TerrainGenerator& terrain);
+		void decorate(const TerrainGenerator& terrain, const Neighborhood& neighbors);
+		void finalize();
+
+		// carves the part of a tunnel that starts in the chunk at originCoord which is inside this chunk
+		void carveTunnel(const TerrainGenerator& terrain, const ChunkCoord& originCoord);
+		void findSurface();
+		void placeTallGrass(const TerrainGenerator& terrain, const ProtoChunk* below);
+		// places the part of the trees that grow from the surface of origin which are inside this chunk
+		void placeTrees(const TerrainGenerator& terrain, const ProtoChunk& origin);
+	};
+
+}
@@ -0,0 +1,118 @@
+#include "RegionFile.h"
+
+#include <string>
+#include <stdexcept>
+#include <cstring>
+#include <algorithm>
+#include <iostream>
+
+#include "util/IOUtils.h"
+#include "util/math/bytes.h"
+
+namespace eng {
+
+	static inline uint32_t readUint32(const unsigned char* const bytes) noexcept {
+		return fromBigEndianByteSpan<uint32_t>(std::span<const unsigned char, 4>(bytes, 4));
+	}
+	static inline void writeUint32(unsigned char* const bytes, const uint32_t value) noexcept {
+		const uint32_t b = toBigEndianUintBytes(value);
+		std::memcpy(bytes, &b, sizeof(b));
+	}
+
+	RegionFile::RegionFile(const std::filesystem::path& path) : file(path) {
+		constexpr size_t headerSize = HEADER_SECTORS * SECTOR_SIZE;
+		if (file.size() < headerSize) { // new file
+			const std::vector<unsigned char> emptyHeader(headerSize, 0);
+			file.write(0, emptyHeader);
+			file.remap();
+		}
+
+		const size_t fileSectors = file.size() / SECTOR_SIZE;
+		usedSectors.assign(fileSectors, false);
+		setSectorsUsed(0, HEADER_SECTORS, true);
+		const unsigned char* const headerBytes = file.getMappedBytes().data();
+		for (size_t i = 0; i < CHUNK_COUNT; i++) {
+			HeaderEntry entry {
+				readUint32(headerBytes + (i * HEADER_ENTRY_SIZE)),
+				readUint32(headerBytes + (i * HEADER_ENTRY_SIZE) + 4),
+			};
+			if (entry.sectorCount == 0) continue;
+			// entries that point outside of the file or into the header are treated as missing
+			if ((entry.sectorOffset < HEADER_SECTORS) || ((static_cast<size_t>(entry.sectorOffset) + entry.sectorCount) > fileSectors)) {
+				std::cerr << "Ignoring invalid chunk entry " << i << " in region file " << path << '\n';
+				continue;
+			}
+			header[i] = entry;
+			setSectorsUsed(entry.sectorOffset, entry.sectorCount, true);
+		}
+	}
+
+	bool RegionFile::contains(const ChunkCoord& chunkCoord) const {
+		std::scoped_lock<std::mutex> lock { mutex };
+		return header[getChunkIndex(chunkCoord)].sectorCount > 0;
+	}
+
+	std::vector<unsigned char> RegionFile::read(const ChunkCoord& chunkCoord) const {
+		std::scoped_lock<std::mutex> lock { mutex };
+		const HeaderEntry& entry = header[getChunkIndex(chunkCoord)];
+		if (entry.sectorCount == 0) return {};
+		const size_t offset = static_cast<size_t>(entry.sectorOffset) * SECTOR_SIZE;
+		const size_t end = offset + (static_cast<size_t>(entry.sectorCount) * SECTOR_SIZE);
+		if (end > file.getMappedBytes().size()) // the payload was written after the file was last mapped
+			file.remap();
+		const auto bytes = file.getMappedBytes();
+		if (end > bytes.size())
+			throw std::runtime_error("Chunk payload extends past the end of the region file");
+
+		const size_t compressedSize = readUint32(bytes.data() + offset);
+		const size_t uncompressedSize = readUint32(bytes.data() + offset + 4);
+		if ((PAYLOAD_HEADER_SIZE + compressedSize) > (end - offset))
+			throw std::runtime_error("Chunk payload is larger than its sectors");
+		return decompressBytes(bytes.subspan(offset + PAYLOAD_HEADER_SIZE, compressedSize), uncompressedSize);
+	}
+
+	void RegionFile::write(const ChunkCoord& chunkCoord, std::span<const unsigned char> compressedPayload, const size_t uncompressedSize) {
+		const size_t sectorCount = (PAYLOAD_HEADER_SIZE + compressedPayload.size() + SECTOR_SIZE - 1) / SECTOR_SIZE;
+		std::vector<unsigned char> sectors(sectorCount * SECTOR_SIZE, 0);
+		writeUint32(sectors.data(), static_cast<uint32_t>(compressedPayload.size()));
+		writeUint32(sectors.data() + 4, static_cast<uint32_t>(uncompressedSize));
+		std::memcpy(sectors.data() + PAYLOAD_HEADER_SIZE, compressedPayload.data(), compressedPayload.size());
+
+		std::scoped_lock<std::mutex> lock { mutex };
+		const size_t chunkIndex = getChunkIndex(chunkCoord);
+		const HeaderEntry oldEntry = header[chunkIndex];
+		const size_t sectorOffset = allocateSectors(sectorCount);
+		file.write(sectorOffset * SECTOR_SIZE, sectors);
+		setSectorsUsed(sectorOffset, sectorCount, true);
+
+		const HeaderEntry newEntry { static_cast<uint32_t>(sectorOffset), static_cast<uint32_t>(sectorCount) };
+		std::array<unsigned char, HEADER_ENTRY_SIZE> entryBytes;
+		writeUint32(entryBytes.data(), newEntry.sectorOffset);
+		writeUint32(entryBytes.data() + 4, newEntry.sectorCount);
+		file.write(chunkIndex * HEADER_ENTRY_SIZE, entryBytes);
+		header[chunkIndex] = newEntry;
+		if (oldEntry.sectorCount > 0)
+			setSectorsUsed(oldEntry.sectorOffset, oldEntry.sectorCount, false);
+	}
+
+	size_t RegionFile::allocateSectors(const size_t count) {
+		size_t runStart = 0, runLength = 0;
+		for (size_t s = HEADER_SECTORS; s < usedSectors.size(); s++) {
+			if (usedSectors[s]) {
+				runLength = 0;
+				continue;
+			}
+			if (runLength == 0) runStart = s;
+			if (++runLength == count) return runStart;
+		}
+		// extend the file, starting from the free sectors at the end of it if there are any
+		return (runLength > 0) ? runStart : usedSectors.size();
+	}
+
+	void RegionFile::setSectorsUsed(const size_t offset, const size_t count, const bool used) {
+		if ((offset + count) > usedSectors.size())
+			usedSectors.resize(offset + count, false);
+		std::fill_n(usedSectors.begin() + offset, count, used);
+	}
+
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstdint>
+#include <array>
+#include <vector>
+#include <span>
+#include <mutex>
+#include <filesystem>
+
+#include "ChunkCoord.h"
+#include "util/MappedFile.h"
+
+namespace eng {
+
+	/*
+	 * Stores the saved data of a 16x16x16 cube of chunks in a single file.
+	 * The file is divided into 4 KiB sectors. It starts with a header containing an entry for each chunk (in zyx order),
+	 * which stores the first sector and the number of sectors of the chunk's payload (or zeros if the chunk isn't saved).
+	 * Each payload starts with its compressed and uncompressed sizes, followed by a zlib-compressed binary NBT compound.
+	 * All integers are big-endian, like NBT.
+	 * Payloads are inflated straight out of a read-only memory mapping of the file.
+	 */
+	class RegionFile {
+	public:
+		static constexpr int WIDTH = 16; // width, depth, and height of a region in chunks
+		static constexpr int LOG2_WIDTH = 4;
+		static constexpr size_t CHUNK_COUNT = WIDTH * WIDTH * WIDTH;
+		static constexpr size_t SECTOR_SIZE = 4096;
+		static constexpr size_t HEADER_ENTRY_SIZE = 8;
+		static constexpr size_t HEADER_SECTORS = (CHUNK_COUNT * HEADER_ENTRY_SIZE) / SECTOR_SIZE;
+		static constexpr size_t PAYLOAD_HEADER_SIZE = 8;
+
+	private:
+		struct HeaderEntry {
+			uint32_t sectorOffset = 0;
+			uint32_t sectorCount = 0;
+		};
+
+		mutable std::mutex mutex;
+		mutable MappedFile file; // remapped by read() after the file has grown
+		std::array<HeaderEntry, CHUNK_COUNT> header {};
+		std::vector<bool> usedSectors;
+
+	public:
+		// opens the region file at path, and creates it if it doesn't exist
+		explicit RegionFile(const std::filesystem::path& path);
+
+		RegionFile(const RegionFile&) = delete;
+		RegionFile& operator =(const RegionFile&) = delete;
+
+		// returns the region that contains a chunk
+		static inline ChunkCoord getRegionCoord(const ChunkCoord& chunkCoord) noexcept {
+			return { chunkCoord.x >> LOG2_WIDTH, chunkCoord.y >> LOG2_WIDTH, chunkCoord.z >> LOG2_WIDTH };
+		}
+
+		bool contains(const ChunkCoord& chunkCoord) const;
+
+		// returns the uncompressed payload of a chunk, or an empty vector if the chunk isn't saved in this region
+		std::vector<unsigned char> read(const ChunkCoord& chunkCoord) const;
+		// replaces the payload of a chunk
+		// the new payload is written to free sectors before the header is updated, so the old payload stays intact if writing fails
+		void write(const ChunkCoord& chunkCoord, std::span<const unsigned char> compressedPayload, size_t uncompressedSize);
+
+	private:
+		static inline size_t getChunkIndex(const ChunkCoord& chunkCoord) noexcept {
+			constexpr int mask = WIDTH - 1;
+			return static_cast<size_t>((((chunkCoord.z & mask) << LOG2_WIDTH) | (chunkCoord.y & mask)) << LOG2_WIDTH) | static_cast<size_t>(chunkCoord.x & mask);
+		}
+
+		// returns the first sector of a run of count free sectors
+		size_t allocateSectors(size_t count);
+		void setSectorsUsed(size_t offset, size_t count, bool used);
+	};
+
+}
@@ -0,0 +1,51 @@
+#include "TerrainDensity.h"
+
+#include <algorithm>
+
+namespace eng {
+
+	TerrainDensity::TerrainDensity(const NoiseGen& noise, const glm::ivec3& chunkOrigin, const Heights terrainHeights) :
+			heights(terrainHeights), originY(chunkOrigin.y) {
+		std::array<double, lattice_volume> samples;
+		noise.fillNoise3D(chunkOrigin + lattice_origin, lattice_size, lattice_step, samples);
+		std::transform(samples.begin(), samples.end(), latticeNoise.begin(), [](const double n) { return static_cast<float>(n); });
+	}
+
+	void TerrainDensity::getColumn(const int x, const int z, Column& column) const {
+		// interpolate between the 4 lattice columns around the column, then along the column
+		const int lx = x / lattice_step.x;
+		const int lz = z / lattice_step.z;
+		const float tx = static_cast<float>(x % lattice_step.x) / static_cast<float>(lattice_step.x);
+		const float tz = static_cast<float>(z % lattice_step.z) / static_cast<float>(lattice_step.z);
+		std::array<float, static_cast<size_t>(lattice_size.y)> levels;
+		for (int ly = 0; ly < lattice_size.y; ly++) {
+			const float n00 = latticeNoise[getLatticeIndex(lx, ly, lz)];
+			const float n10 = latticeNoise[getLatticeIndex(lx + 1, ly, lz)];
+			const float n01 = latticeNoise[getLatticeIndex(lx, ly, lz + 1)];
+			const float n11 = latticeNoise[getLatticeIndex(lx + 1, ly, lz + 1)];
+			const float n0 = n00 + ((n10 - n00) * tx);
+			const float n1 = n01 + ((n11 - n01) * tx);
+			levels[static_cast<size_t>(ly)] = n0 + ((n1 - n0) * tz);
+		}
+
+		std::array<float, static_cast<size_t>((lattice_size.y - 1) * lattice_step.y)> noise; // from the bottom of the lattice
+		for (int ly = 0; ly < (lattice_size.y - 1); ly++) {
+			const float n0 = levels[static_cast<size_t>(ly)];
+			const float step = (levels[static_cast<size_t>(ly + 1)] - n0) * (1.0f / static_cast<float>(lattice_step.y));
+			for (int cy = 0; cy < lattice_step.y; cy++)
+				noise[static_cast<size_t>((ly * lattice_step.y) + cy)] = n0 + (step * static_cast<float>(cy));
+		}
+
+		// the block at the terrain height is the top of the terrain when the noise is neutral
+		// depth / height_falloff is the smaller term above the terrain height, and depth / depth_falloff is the smaller term below it
+		constexpr auto noise_offset = static_cast<size_t>(-column_below - lattice_origin.y);
+		const int terrainHeight = heights[static_cast<size_t>((z * width) + x)];
+		const float bottomDepth = static_cast<float>(terrainHeight - (originY - column_below)) + 0.5f;
+		for (size_t i = 0; i < column_height; i++) {
+			const float depth = bottomDepth - static_cast<float>(i);
+			const float surface = std::min(std::min(depth * (1.0f / height_falloff), depth * (1.0f / depth_falloff)), 1.0f);
+			column[i] = surface + ((noise[i + noise_offset] - 0.5f) * noise_strength);
+		}
+	}
+
+}
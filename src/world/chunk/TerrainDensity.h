@@ -0,0 +1,71 @@
+#pragma once
+
+#include <array>
+#include <span>
+#include <cstddef>
+
+#include <glm/vec3.hpp>
+
+#include "chunk_consts.h"
+#include "util/math/NoiseGen.h"
+
+namespace eng {
+
+	/*
+	 * The 3d terrain density of a chunk, where blocks with a positive density are solid.
+	 * The density is a falloff around the 2d terrain height plus 3d noise, which carves overhangs near the surface and caves below it.
+	 * The noise is only sampled on a coarse lattice and trilinearly interpolated in between, so a chunk needs a few hundred noise samples
+	 * instead of one per block.
+	 * Columns also cover a few blocks above and below the chunk, so the surface layers can be found without generating the neighboring chunks.
+	 */
+	class TerrainDensity {
+	public:
+		static constexpr glm::ivec3 lattice_step { 4, 8, 4 }; // blocks between lattice points on each axis
+		static constexpr int column_below = 1; // blocks below the chunk in each column
+		static constexpr int column_above = 3; // blocks above the chunk in each column, enough to tell the depth of the surface layers
+		static constexpr size_t column_height = chunk_width + column_below + column_above;
+
+		// the density of each block in a column, where index column_below is the bottom of the chunk
+		using Column = std::array<float, column_height>;
+		using Heights = std::span<const int, chunk_layer_size>; // terrain heights, indexed by (z * chunk_width) + x
+
+		// the density rises over this many blocks below the terrain height, and then stays constant so that the noise can carve caves
+		static constexpr float depth_falloff = 16.0f;
+		// the density falls faster above the terrain height, so the noise only makes overhangs near the surface
+		static constexpr float height_falloff = 4.0f;
+		static constexpr float noise_strength = 6.0f;
+
+	private:
+		static constexpr int width = static_cast<int>(chunk_width);
+		static_assert(((width % lattice_step.x) == 0) && ((width % lattice_step.y) == 0) && ((width % lattice_step.z) == 0),
+				"The terrain density lattice must line up with the chunk borders");
+
+		// the lattice starts a step below the chunk, and ends at the first point at or above the top of the column
+		static constexpr glm::ivec3 lattice_origin { 0, -lattice_step.y, 0 };
+		static constexpr glm::ivec3 lattice_size {
+			(width / lattice_step.x) + 1,
+			((width + column_above - 1 - lattice_origin.y + lattice_step.y - 1) / lattice_step.y) + 1,
+			(width / lattice_step.z) + 1,
+		};
+		static constexpr size_t lattice_volume = static_cast<size_t>(lattice_size.x * lattice_size.y * lattice_size.z);
+
+		std::array<float, lattice_volume> latticeNoise; // indexed by (((z * lattice_size.y) + y) * lattice_size.x) + x
+		Heights heights;
+		int originY;
+
+	public:
+		// chunkOrigin is the block position of the chunk's origin
+		TerrainDensity(const NoiseGen& noise, const glm::ivec3& chunkOrigin, Heights terrainHeights);
+
+		// x and z are relative to the chunk's origin
+		void getColumn(int x, int z, Column& column) const;
+
+		static inline constexpr bool isSolid(const float density) noexcept { return density > 0.0f; }
+
+	private:
+		static inline constexpr size_t getLatticeIndex(const int x, const int y, const int z) noexcept {
+			return static_cast<size_t>((((z * lattice_size.y) + y) * lattice_size.x) + x);
+		}
+	};
+
+}
@@ -0,0 +1,59 @@
+#include "TerrainGenerator.h"
+
+#include <vector>
+
+#include "chunk_consts.h"
+#include "ChunkCoord.h"
+#include "TerrainDensity.h"
+
+namespace eng {
+
+	TerrainGenerator::TerrainGenerator(const RNG::seed_t seed, const size_t heightCacheCapacity, const NoiseGen::GradientMode gradientMode) :
+			seed(seed),
+			//terrainGenNoise(seed, { 53.0, 1.0, 0.8, 3 }) {
+			terrainGenNoise(seed, { 123.0, 1.0, 0.6, 4 }, gradientMode),
+			terrainDensityNoise(seed + 1, { 64.0, 1.0, 0.5, 3 }, gradientMode),
+			terrainHeightCache(heightCacheCapacity) {}
+
+	int TerrainGenerator::getTerrainHeight(const int x, const int z) const {
+		const auto noise = terrainGenNoise.getNoise({ x, z });
+		//const auto terrainHeight = static_cast<int>(noise * 188) - 94;
+		const auto terrainHeight = static_cast<int>(noise * 512) - 128;
+
+		return terrainHeight;
+	}
+	void TerrainGenerator::getTerrainHeights(const glm::ivec2& origin, const glm::ivec2& size, const std::span<int> out) const {
+		std::vector<double> noise(static_cast<size_t>(size.x) * static_cast<size_t>(size.y));
+		terrainGenNoise.fillNoise2D(origin, size, noise);
+		for (size_t i = 0; i < noise.size(); i++)
+			out[i] = static_cast<int>(noise[i] * 512) - 128;
+	}
+	TerrainHeightCache::HeightsPtr TerrainGenerator::getColumnTerrainHeights(const glm::ivec2& columnCoord) const {
+		return terrainHeightCache.get(columnCoord, [&](TerrainHeightCache::Heights& heights) {
+			constexpr int width = static_cast<int>(chunk_width);
+			getTerrainHeights(columnCoord * width, { width, width }, heights);
+		});
+	}
+	int TerrainGenerator::getDensitySurfaceHeight(const int x, const int z) const {
+		// the density can only be solid a few blocks above the terrain height, so the chunk above the terrain height's chunk is high enough
+		const int terrainHeight = getTerrainHeight(x, z);
+		const ChunkCoord terrainChunkCoord = ChunkCoord::fromBlockPos({ x, terrainHeight, z });
+		const TerrainHeightCache::HeightsPtr terrainHeights = getColumnTerrainHeights({ terrainChunkCoord.x, terrainChunkCoord.z });
+		const glm::ivec3 cPos = terrainChunkCoord.getRelativeBlockPos({ x, terrainHeight, z });
+		TerrainDensity::Column columnDensity;
+		constexpr auto columnBelow = static_cast<size_t>(TerrainDensity::column_below);
+		// caves can open up at the terrain height, so the search continues a few chunks down
+		constexpr int max_chunks_below = 4;
+		for (int cy = terrainChunkCoord.y + 1; cy >= (terrainChunkCoord.y - max_chunks_below); cy--) {
+			const glm::ivec3 chunkOrigin = ChunkCoord::toBlockPos({ terrainChunkCoord.x, cy, terrainChunkCoord.z });
+			const TerrainDensity density(terrainDensityNoise, chunkOrigin, *terrainHeights);
+			density.getColumn(cPos.x, cPos.z, columnDensity);
+			for (int y = static_cast<int>(chunk_width) - 1; y >= 0; y--) {
+				if (TerrainDensity::isSolid(columnDensity[static_cast<size_t>(y) + columnBelow]))
+					return chunkOrigin.y + y;
+			}
+		}
+		return terrainHeight; // the column is hollow all the way down
+	}
+
+}
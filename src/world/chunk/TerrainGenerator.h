@@ -0,0 +1,53 @@
+#pragma once
+
+#include <span>
+#include <cstddef>
+
+#include <glm/vec2.hpp>
+
+#include "TerrainHeightCache.h"
+#include "util/math/RNG.h"
+#include "util/math/NoiseGen.h"
+
+namespace eng {
+
+	/*
+	 * The seeded noise and caches that chunk generation reads.
+	 * Generation only depends on the terrain generator and the chunk coordinate, so chunks can be generated without a world
+	 * (e.g. by the world generation benchmark). The world owns one and forwards its terrain queries to it.
+	 * Every method is safe to call from the chunk generator threads.
+	 */
+	class TerrainGenerator {
+	private:
+		RNG::seed_t seed;
+		NoiseGen terrainGenNoise;
+		NoiseGen terrainDensityNoise; // carves overhangs and caves into the terrain
+		mutable TerrainHeightCache terrainHeightCache; // terrain heights of recently generated chunk columns, shared by the generator threads
+
+	public:
+		// gradientMode is used by every noise generator (see NoiseGen::GradientMode)
+		TerrainGenerator(RNG::seed_t seed, size_t heightCacheCapacity, NoiseGen::GradientMode gradientMode = NoiseGen::GradientMode::Permutation);
+
+		TerrainGenerator(const TerrainGenerator&) = delete;
+		TerrainGenerator& operator =(const TerrainGenerator&) = delete;
+
+		inline RNG::seed_t getSeed() const noexcept { return seed; }
+		inline NoiseGen::GradientMode getGradientMode() const noexcept { return terrainGenNoise.getGradientMode(); }
+
+		int getTerrainHeight(const int x, const int z) const;
+		// fills out with the terrain height of each column in the box [origin, origin + size), indexed by (z * size.x) + x
+		// where origin and size are (x, z) in block coordinates
+		void getTerrainHeights(const glm::ivec2& origin, const glm::ivec2& size, std::span<int> out) const;
+		// returns the terrain heights of the chunk column at chunk (x, z) coordinate columnCoord, indexed by (z * chunk_width) + x
+		// the heights are cached, so that every chunk in the column can share them
+		TerrainHeightCache::HeightsPtr getColumnTerrainHeights(const glm::ivec2& columnCoord) const;
+		// returns the y coordinate of the topmost solid block of the terrain density at (x, z), which can be several blocks above
+		// getTerrainHeight. carvers and decorations aren't included, so it's only an estimate of the generated surface
+		int getDensitySurfaceHeight(int x, int z) const;
+		inline const NoiseGen& getTerrainDensityNoise() const noexcept { return terrainDensityNoise; }
+
+		inline void setHeightCacheCapacity(const size_t capacity) { terrainHeightCache.setCapacity(capacity); }
+		inline TerrainHeightCache::Stats getHeightCacheStats() const { return terrainHeightCache.getStats(); }
+	};
+
+}
@@ -0,0 +1,56 @@
+#include "TerrainHeightCache.h"
+
+namespace eng {
+
+	void TerrainHeightCache::setCapacity(const size_t capacity) {
+		std::scoped_lock<std::mutex> lock { mutex };
+		this->capacity = capacity;
+		evictExcess();
+	}
+
+	void TerrainHeightCache::clear() {
+		std::scoped_lock<std::mutex> lock { mutex };
+		columns.clear();
+		lru.clear();
+		stats.columns = 0;
+	}
+
+	TerrainHeightCache::Stats TerrainHeightCache::getStats() const {
+		std::scoped_lock<std::mutex> lock { mutex };
+		return stats;
+	}
+
+	TerrainHeightCache::HeightsPtr TerrainHeightCache::find(const glm::ivec2& columnCoord) {
+		std::scoped_lock<std::mutex> lock { mutex };
+		const auto it = columns.find(columnCoord);
+		if (it == columns.end()) {
+			stats.misses++;
+			return nullptr;
+		}
+		stats.hits++;
+		lru.splice(lru.begin(), lru, it->second.lruPos);
+		return it->second.heights;
+	}
+
+	TerrainHeightCache::HeightsPtr TerrainHeightCache::insert(const glm::ivec2& columnCoord, HeightsPtr heights) {
+		std::scoped_lock<std::mutex> lock { mutex };
+		if (const auto it = columns.find(columnCoord); it != columns.end()) {
+			lru.splice(lru.begin(), lru, it->second.lruPos);
+			return it->second.heights;
+		}
+		lru.push_front(columnCoord);
+		columns.emplace(columnCoord, Entry { heights, lru.begin() });
+		evictExcess();
+		return heights;
+	}
+
+	void TerrainHeightCache::evictExcess() {
+		while (columns.size() > capacity) {
+			columns.erase(lru.back());
+			lru.pop_back();
+			stats.evictions++;
+		}
+		stats.columns = columns.size();
+	}
+
+}
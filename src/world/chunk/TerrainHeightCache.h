@@ -0,0 +1,85 @@
+#pragma once
+
+#include <array>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <cstdint>
+#include <cstddef>
+
+#include <glm/vec2.hpp>
+#include <glm/gtx/hash.hpp>
+
+#include "chunk_consts.h"
+
+namespace eng {
+
+	/*
+	 * Caches the terrain height grid of each chunk column, so that every chunk in a vertical stack reuses the heights computed for the first one
+	 * instead of sampling the terrain noise again.
+	 * Columns are evicted least recently used first once there are more than capacity of them. The world keeps the capacity at the number of
+	 * columns that generation can reach from its loading area, so the columns that have left it are the ones that get evicted.
+	 * The cache is shared by the chunk generator threads, so every method is thread safe.
+	 */
+	class TerrainHeightCache {
+	public:
+		using Heights = std::array<int, chunk_layer_size>; // indexed by (z * chunk_width) + x
+		using HeightsPtr = std::shared_ptr<const Heights>;
+
+		struct Stats {
+			uint64_t hits = 0;
+			uint64_t misses = 0;
+			uint64_t evictions = 0;
+			size_t columns = 0; // columns that are currently cached
+
+			inline double getHitRate() const noexcept {
+				const uint64_t lookups = hits + misses;
+				return (lookups > 0) ? (static_cast<double>(hits) / static_cast<double>(lookups)) : 0.0;
+			}
+		};
+
+	private:
+		struct Entry {
+			HeightsPtr heights;
+			std::list<glm::ivec2>::iterator lruPos;
+		};
+
+		mutable std::mutex mutex;
+		std::unordered_map<glm::ivec2, Entry> columns; // by chunk (x, z) coordinate
+		std::list<glm::ivec2> lru; // cached columns, most recently used first
+		size_t capacity;
+		Stats stats;
+
+	public:
+		explicit TerrainHeightCache(size_t capacity) : capacity(capacity) {}
+
+		TerrainHeightCache(const TerrainHeightCache&) = delete;
+		TerrainHeightCache& operator =(const TerrainHeightCache&) = delete;
+
+		// returns the heights of the column at chunk (x, z) coordinate columnCoord, calling compute(Heights&) to fill them in if they aren't cached
+		// compute is called without holding the lock, so threads that miss the same column at the same time may both compute it
+		template<typename F>
+		HeightsPtr get(const glm::ivec2& columnCoord, F&& compute) {
+			if (HeightsPtr heights = find(columnCoord)) return heights;
+			auto heights = std::make_shared<Heights>();
+			compute(*heights);
+			return insert(columnCoord, std::move(heights));
+		}
+
+		// evicts the least recently used columns if there are more than capacity
+		void setCapacity(size_t capacity);
+		void clear();
+
+		Stats getStats() const;
+
+	private:
+		// counts a hit or miss, and marks the column as most recently used if it's cached
+		HeightsPtr find(const glm::ivec2& columnCoord);
+		// returns the cached heights if another thread inserted the column first
+		HeightsPtr insert(const glm::ivec2& columnCoord, HeightsPtr heights);
+		void evictExcess();
+	};
+
+}
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 
 #include "util/math/math.h"
 
@@ -12,4 +13,16 @@ namespace eng {
 	inline constexpr size_t chunk_volume = chunk_layer_size * chunk_width; // total number of blocks in a chunk
 	inline constexpr size_t chunk_log2_width = constexpr_floor_log2(chunk_width);
 
+	// chunks are divided into cubic sub-regions, so that small changes only have to remesh part of a chunk
+	inline constexpr size_t chunk_region_width = 8; // width, depth, and height of a chunk sub-region in blocks
+	inline constexpr size_t chunk_log2_region_width = constexpr_floor_log2(chunk_region_width);
+	inline constexpr size_t chunk_regions_per_axis = chunk_width / chunk_region_width;
+	inline constexpr size_t chunk_region_count = chunk_regions_per_axis * chunk_regions_per_axis * chunk_regions_per_axis;
+	static_assert(is_pow2(chunk_region_width) && (chunk_region_width <= chunk_width), "Chunk sub-region size must be a power of 2 no larger than the chunk size");
+
+	using chunk_region_mask = uint64_t; // one bit per chunk sub-region
+	static_assert(chunk_region_count <= (sizeof(chunk_region_mask) * 8), "Too many chunk sub-regions for chunk_region_mask");
+	inline constexpr chunk_region_mask all_chunk_regions = (chunk_region_count == (sizeof(chunk_region_mask) * 8)) ?
+		~chunk_region_mask{0} : ((chunk_region_mask{1} << chunk_region_count) - 1);
+
 }
\ No newline at end of file